@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include "advanced_ai.h"
+#include "evalcache.h"
 #include "game.h"
 
 /*
@@ -33,10 +34,12 @@ int AdvancedAI_GetReady(void* p, void* game) {
 
   CardArray_Sort(&player->cards, NULL);
   CardArray_Copy(&player->record, &player->cards);
+  HandCtx_Setup(&player->ctx, &player->cards);
 #if (PRINT_GAME_LOG == 1)
   CardArray_Print(&player->record);
 #endif /* ifdef PRINT_GAME_LOG */
-  player->handlist = HandList_AdvancedAnalyze(&player->cards);
+  HandList_AdvancedAnalyze(&player->cards, &player->handlist);
+  HandIndex_Build(&player->handindex, &player->handlist);
 
   return 0;
 }
@@ -80,8 +83,12 @@ int AdvancedAI_Beat(void* p, void* g) {
 
   tobeat = &((game_t*)game)->lastHand;
 
-  canbeat = HandList_BestBeat(&player->cards, tobeat, &beat,
-                              HandList_AdvancedEvaluator);
+  /* nothing can beat it, pass without searching */
+  if (!HandList_CanBeat(&player->cards, tobeat))
+    return 0;
+
+  canbeat = HandList_BestBeatCtx(&player->ctx, tobeat, &beat,
+                                 EvalCache_AdvancedEvaluator);
 
   /*
      canbeat = HandList_SearchBeat(&player->cards, tobeat, &beat);
@@ -115,9 +122,10 @@ int AdvancedAI_Beat(void* p, void* g) {
   }
 
   if (canbeat) {
-    CardArray_Subtract(&player->cards, &beat.cards);
-    rk_list_clear_destroy(player->handlist);
-    player->handlist = HandList_AdvancedAnalyze(&player->cards);
+    CardArray_SubtractHand(&player->cards, &beat.cards);
+    HandCtx_Remove(&player->ctx, &beat.cards);
+    HandList_AdvancedAnalyze(&player->cards, &player->handlist);
+    HandIndex_Build(&player->handindex, &player->handlist);
     Hand_Copy(tobeat, &beat);
   }
 
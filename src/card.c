@@ -24,6 +24,10 @@ SOFTWARE.
 
 #include "card.h"
 
+#ifdef LL_SSE2
+#include <emmintrin.h>
+#endif
+
 const uint8_t _card_set[] = {
     0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B,
     0x1C, 0x1D, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29,
@@ -31,6 +35,203 @@ const uint8_t _card_set[] = {
     0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x41, 0x42, 0x43, 0x44, 0x45,
     0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x1E, 0x2F};
 
+/*
+ * ************************************************************
+ * rank count
+ * ************************************************************
+ */
+
+void RankCount_Build(rank_count_t* rc, const uint8_t* cards, int length) {
+  int i = 0;
+
+  RankCount_Clear(rc);
+
+  for (i = 0; i < length; i++)
+    rc->n[CARD_RANK(cards[i])]++;
+}
+
+#ifdef LL_SSE2
+
+#define RC_LOAD(rc) _mm_loadu_si128((const __m128i*)(rc)->n)
+#define RC_STORE(rc, v) _mm_storeu_si128((__m128i*)(rc)->n, (v))
+
+void RankCount_Add(rank_count_t* dst, const rank_count_t* a,
+                   const rank_count_t* b) {
+  RC_STORE(dst, _mm_add_epi8(RC_LOAD(a), RC_LOAD(b)));
+}
+
+void RankCount_Sub(rank_count_t* dst, const rank_count_t* a,
+                   const rank_count_t* b) {
+  RC_STORE(dst, _mm_subs_epu8(RC_LOAD(a), RC_LOAD(b)));
+}
+
+int RankCount_Equal(const rank_count_t* a, const rank_count_t* b) {
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(RC_LOAD(a), RC_LOAD(b))) == 0xFFFF;
+}
+
+int RankCount_Contain(const rank_count_t* a, const rank_count_t* b) {
+  /* a >= b <=> max(a, b) == a */
+  __m128i va = RC_LOAD(a);
+
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(va, RC_LOAD(b)), va)) ==
+         0xFFFF;
+}
+
+uint16_t RankCount_MaskGE(const rank_count_t* rc, int k) {
+  __m128i v = RC_LOAD(rc);
+  __m128i vk = _mm_set1_epi8((char)k);
+
+  return (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, vk), v));
+}
+
+uint16_t RankCount_MaskEQ(const rank_count_t* rc, int k) {
+  return (uint16_t)_mm_movemask_epi8(
+      _mm_cmpeq_epi8(RC_LOAD(rc), _mm_set1_epi8((char)k)));
+}
+
+#else /* ifdef LL_SSE2 */
+
+void RankCount_Add(rank_count_t* dst, const rank_count_t* a,
+                   const rank_count_t* b) {
+  int i = 0;
+
+  for (i = 0; i < CARD_RANK_END; i++)
+    dst->n[i] = (uint8_t)(a->n[i] + b->n[i]);
+}
+
+void RankCount_Sub(rank_count_t* dst, const rank_count_t* a,
+                   const rank_count_t* b) {
+  int i = 0;
+
+  for (i = 0; i < CARD_RANK_END; i++)
+    dst->n[i] = a->n[i] > b->n[i] ? (uint8_t)(a->n[i] - b->n[i]) : 0;
+}
+
+int RankCount_Equal(const rank_count_t* a, const rank_count_t* b) {
+  return (a->q[0] == b->q[0]) && (a->q[1] == b->q[1]);
+}
+
+int RankCount_Contain(const rank_count_t* a, const rank_count_t* b) {
+  int i = 0;
+
+  for (i = 0; i < CARD_RANK_END; i++) {
+    if (a->n[i] < b->n[i])
+      return 0;
+  }
+
+  return 1;
+}
+
+uint16_t RankCount_MaskGE(const rank_count_t* rc, int k) {
+  int i = 0;
+  uint16_t mask = 0;
+
+  for (i = 0; i < CARD_RANK_END; i++) {
+    if (rc->n[i] >= k)
+      mask |= (uint16_t)(1 << i);
+  }
+
+  return mask;
+}
+
+uint16_t RankCount_MaskEQ(const rank_count_t* rc, int k) {
+  int i = 0;
+  uint16_t mask = 0;
+
+  for (i = 0; i < CARD_RANK_END; i++) {
+    if (rc->n[i] == k)
+      mask |= (uint16_t)(1 << i);
+  }
+
+  return mask;
+}
+
+#endif /* ifdef LL_SSE2 */
+
+int RankCount_FindChain(const rank_count_t* rc, int k, int length,
+                        int above) {
+  return RankMask_FindRun(RankCount_MaskGE(rc, k), length, above);
+}
+
+/*
+ * ************************************************************
+ * rank mask
+ * ************************************************************
+ */
+
+uint16_t RankMask_RunStarts(uint16_t mask, int length) {
+  int step = 0;
+  uint32_t start = mask & RANK_MASK_CHAIN;
+
+  /*
+   * start covers runs of step ranks, double it until the rest fits,
+   * so only log2(length) shifts are needed
+   */
+  for (step = 1; (step < length) && (start != 0); step *= 2) {
+    if (step * 2 > length) {
+      start &= start >> (length - step);
+      break;
+    }
+
+    start &= start >> step;
+  }
+
+  return (uint16_t)start;
+}
+
+int RankMask_FindRun(uint16_t mask, int length, int above) {
+  uint32_t start = RankMask_RunStarts(mask, length);
+
+  start &= ~((2u << above) - 1);
+
+  return start != 0 ? (int)LMath_Ctz64(start) : 0;
+}
+
+int RankMask_LongestRun(uint16_t mask, int* low) {
+  int length = 0;
+  uint32_t start = mask & RANK_MASK_CHAIN;
+  uint32_t last = 0;
+
+  /* each round drops the top rank of every run */
+  while (start != 0) {
+    last = start;
+    start &= start >> 1;
+    length++;
+  }
+
+  *low = (last != 0) ? (int)LMath_Ctz64(last) : 0;
+
+  return length;
+}
+
+int RankMask_Runs(uint16_t mask, uint8_t* lows, uint8_t* lengths) {
+  int n = 0;
+  int top = 0;
+  int low = 0;
+  uint32_t chain = mask & RANK_MASK_CHAIN;
+  uint32_t starts = chain & ~(chain << 1);
+  uint32_t ends = chain & ~(chain >> 1);
+
+  while (ends != 0) {
+    top = 63 - LMath_Clz64(ends);
+    low = 63 - LMath_Clz64(starts & ((2u << top) - 1));
+
+    lows[n] = (uint8_t)low;
+    lengths[n] = (uint8_t)(top - low + 1);
+    n++;
+
+    ends &= ~(1u << top);
+  }
+
+  return n;
+}
+
+/*
+ * ************************************************************
+ * card array
+ * ************************************************************
+ */
+
 void* CardArray_InitFromString(card_array_t* array, const char* str) {
   uint8_t card = 0;
   const char* p = str;
@@ -127,6 +328,19 @@ void* CardArray_InitFromString(card_array_t* array, const char* str) {
 void CardArray_Reset(card_array_t* array) {
   memcpy(array->cards, _card_set, sizeof(uint8_t) * CARD_SET_LENGTH);
   array->length = CARD_SET_LENGTH;
+  RankCount_Build(&array->ranks, array->cards, array->length);
+}
+
+void CardArray_FromRanks(card_array_t* array, const rank_count_t* ranks) {
+  int i = 0;
+  int j = 0;
+
+  CardArray_Clear(array);
+
+  for (i = CARD_RANK_BEG; i < CARD_RANK_END; i++) {
+    for (j = 0; j < ranks->n[i]; j++)
+      CardArray_PushBack(array, Card_Make(CARD_SUIT_CLUB + (j << 4), i));
+  }
 }
 
 int CardArray_Concat(card_array_t* head, card_array_t* tail) {
@@ -139,6 +353,15 @@ int CardArray_Concat(card_array_t* head, card_array_t* tail) {
     length = slot >= tail->length ? tail->length : slot;
     memcpy(&head->cards[head->length], tail->cards, length);
     head->length += length;
+
+    if (length == tail->length) {
+      RankCount_Add(&head->ranks, &head->ranks, &tail->ranks);
+    } else {
+      int i = 0;
+
+      for (i = 0; i < length; i++)
+        head->ranks.n[CARD_RANK(tail->cards[i])]++;
+    }
   } else {
     length = 0;
   }
@@ -146,88 +369,53 @@ int CardArray_Concat(card_array_t* head, card_array_t* tail) {
   return length;
 }
 
-void CardArray_Subtract(card_array_t* from, card_array_t* sub) {
+void _CardArray_SubtractSet(card_array_t* from, card_set_t mask) {
   int i = 0;
-  int j = 0;
-  uint8_t card = 0;
-  card_array_t temp;
-
-  CardArray_Clear(&temp);
+  int length = 0;
 
   for (i = 0; i < from->length; i++) {
-    card = from->cards[i];
-
-    for (j = 0; j < sub->length; j++) {
-      if (card == sub->cards[j]) {
-        card = 0;
-        break;
-      }
-    }
-
-    if (card != 0)
-      CardArray_PushBack(&temp, card);
+    if (!CardSet_Has(mask, from->cards[i]))
+      from->cards[length++] = from->cards[i];
+    else
+      from->ranks.n[CARD_RANK(from->cards[i])]--;
   }
 
-  CardArray_Copy(from, &temp);
+  memset(from->cards + length, 0, from->length - length);
+  from->length = length;
 }
 
-int CardArray_IsIdentity(card_array_t* a, card_array_t* b) {
-  int i = 0;
-  int identity = 1;
-  card_array_t ta, tb;
+void CardArray_Subtract(card_array_t* from, card_array_t* sub) {
+  _CardArray_SubtractSet(from, CardSet_FromArray(sub));
+}
 
+int CardArray_IsIdentity(card_array_t* a, card_array_t* b) {
   if (a == b)
     return 1;
 
-  identity = a->length - b->length;
-
-  if (identity == 0) {
-    CardArray_Copy(&ta, a);
-    CardArray_Copy(&tb, b);
-    CardArray_Sort(&ta, NULL);
-    CardArray_Sort(&tb, NULL);
+  if (a->length != b->length)
+    return 0;
 
-    for (i = 0; i < a->length; i++) {
-      if (ta.cards[i] != tb.cards[i]) {
-        identity = 0;
-        break;
-      }
-    }
-  }
-
-  return identity;
+  return CardSet_FromArray(a) == CardSet_FromArray(b) ? 1 : 0;
 }
 
 int CardArray_IsContain(card_array_t* array, card_array_t* segment) {
-  int contain = 0;
-  int i = 0;
-  int j = 0;
-  card_array_t temp;
-
   if ((array->length == 0) || (segment->length == 0))
-    return contain;
-
-  CardArray_Copy(&temp, segment);
-
-  if (array->length >= segment->length) {
-    for (i = 0; i < array->length; i++) {
-      for (j = 0; j < temp.length; j++) {
-        if (array->cards[i] == temp.cards[j]) {
-          CardArray_RemoveCard(&temp, temp.cards[j]);
-          break;
-        }
-      }
-    }
+    return 0;
 
-    contain = temp.length == 0 ? 1 : 0;
-  }
+  if (array->length < segment->length)
+    return 0;
 
-  return contain;
+  return CardSet_IsSubset(CardSet_FromArray(array),
+                          CardSet_FromArray(segment))
+             ? 1
+             : 0;
 }
 
 void CardArray_PushBack(card_array_t* array, uint8_t card) {
-  if (!CardArray_IsFull(array))
+  if (!CardArray_IsFull(array)) {
     array->cards[array->length++] = card;
+    array->ranks.n[CARD_RANK(card)]++;
+  }
 }
 
 uint8_t CardArray_PushFront(card_array_t* array, uint8_t card) {
@@ -238,6 +426,7 @@ uint8_t CardArray_PushFront(card_array_t* array, uint8_t card) {
     array->cards[0] = card;
 
     array->length++;
+    array->ranks.n[CARD_RANK(card)]++;
 
     ret = card;
   }
@@ -250,8 +439,10 @@ uint8_t CardArray_PopFront(card_array_t* array) {
 
   if (!CardArray_IsEmpty(array)) {
     card = array->cards[0];
+    array->length--;
     memmove(array->cards, array->cards + 1, array->length);
-    array->cards[array->length--] = 0;
+    array->cards[array->length] = 0;
+    array->ranks.n[CARD_RANK(card)]--;
   }
 
   return card;
@@ -264,26 +455,37 @@ uint8_t CardArray_PopBack(card_array_t* array) {
     card = array->cards[array->length - 1];
     array->cards[array->length - 1] = 0;
     array->length--;
+    array->ranks.n[CARD_RANK(card)]--;
   }
 
   return card;
 }
 
 int CardArray_DropFront(card_array_t* array, int count) {
+  int i = 0;
   int drop = 0;
 
   drop = (array->length >= count) ? count : array->length;
-  memmove(array->cards, array->cards + drop, array->length);
+
+  for (i = 0; i < drop; i++)
+    array->ranks.n[CARD_RANK(array->cards[i])]--;
+
   array->length -= drop;
+  memmove(array->cards, array->cards + drop, array->length);
   memset(array->cards + array->length, 0, drop);
 
   return drop;
 }
 
 int CardArray_DropBack(card_array_t* array, int count) {
+  int i = 0;
   int drop = 0;
 
   drop = (array->length >= count) ? count : array->length;
+
+  for (i = array->length - drop; i < array->length; i++)
+    array->ranks.n[CARD_RANK(array->cards[i])]--;
+
   memset(array->cards + array->length - drop, 0, drop);
   array->length -= drop;
 
@@ -301,6 +503,7 @@ void CardArray_Insert(card_array_t* array, int before, uint8_t card) {
               array->length - before);
       array->cards[before] = card;
       array->length++;
+      array->ranks.n[CARD_RANK(card)]++;
     }
   }
 }
@@ -316,6 +519,7 @@ uint8_t CardArray_Remove(card_array_t* array, int where) {
     } else if ((where > 0) && (where < array->length - 1)) {
       ret = array->cards[where];
       array->length--;
+      array->ranks.n[CARD_RANK(ret)]--;
       memmove(array->cards + where, array->cards + where + 1,
               array->length - where);
       array->cards[array->length] = 0;
@@ -364,17 +568,16 @@ void CardArray_CopyRank(card_array_t* dst, card_array_t* src, uint8_t rank) {
 
 void CardArray_RemoveRank(card_array_t* array, uint8_t rank) {
   int i = 0;
-
-  card_array_t temp;
-
-  CardArray_Clear(&temp);
+  int length = 0;
 
   for (i = 0; i < array->length; i++) {
     if (CARD_RANK(array->cards[i]) != rank)
-      CardArray_PushBack(&temp, array->cards[i]);
+      array->cards[length++] = array->cards[i];
   }
 
-  CardArray_Copy(array, &temp);
+  memset(array->cards + length, 0, array->length - length);
+  array->length = length;
+  array->ranks.n[rank] = 0;
 }
 
 int CardArray_StandardSort(const void* a, const void* b) {
@@ -388,10 +591,52 @@ int CardArray_StandardSort(const void* a, const void* b) {
   return rb - ra;
 }
 
+/*
+ * counting sort by rank for the standard order
+ * the maintained rank count gives every rank bucket its offset,
+ * cards inside a bucket only differ in suit and are insertion sorted
+ */
+void _CardArray_RankSort(card_array_t* array) {
+  int i = 0;
+  int j = 0;
+  int rank = 0;
+  int offset = 0;
+  uint8_t card = 0;
+  uint8_t begin[CARD_RANK_END];
+  uint8_t end[CARD_RANK_END];
+  uint8_t sorted[CARD_ARRAY_PRESET_LENGTH];
+
+  /* higher rank first */
+  for (rank = CARD_RANK_END - 1; rank >= 0; rank--) {
+    begin[rank] = (uint8_t)offset;
+    end[rank] = (uint8_t)offset;
+    offset += array->ranks.n[rank];
+  }
+
+  for (i = 0; i < array->length; i++) {
+    card = array->cards[i];
+    rank = CARD_RANK(card);
+    j = end[rank]++;
+
+    /* same rank, higher suit first */
+    while ((j > begin[rank]) && (sorted[j - 1] < card)) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+
+    sorted[j] = card;
+  }
+
+  memcpy(array->cards, sorted, array->length);
+}
+
 void CardArray_Sort(card_array_t* array,
                     int (*comparator)(const void*, const void*)) {
-  if (comparator == NULL)
-    qsort(array->cards, array->length, sizeof(uint8_t), CardArray_StandardSort);
+  if (array->length < 2)
+    return;
+
+  if ((comparator == NULL) || (comparator == CardArray_StandardSort))
+    _CardArray_RankSort(array);
   else
     qsort(array->cards, array->length, sizeof(uint8_t), comparator);
 }
@@ -473,3 +718,223 @@ void CardArray_Print(card_array_t* array) {
 
   DBGLog("\n");
 }
+
+/*
+ * ************************************************************
+ * card set
+ * ************************************************************
+ */
+
+card_set_t CardSet_FromCards(const uint8_t* cards, int length) {
+  int i = 0;
+  card_set_t set = CARD_SET_EMPTY;
+
+  for (i = 0; i < length; i++)
+    set |= CardSet_Bit(cards[i]);
+
+  return set;
+}
+
+card_set_t CardSet_FromArray(card_array_t* array) {
+  return CardSet_FromCards(array->cards, array->length);
+}
+
+void CardSet_ToArray(card_set_t set, card_array_t* array) {
+  int bit = 0;
+
+  CardArray_Clear(array);
+
+  /* highest bit first, which is the standard sort order */
+  while (set != CARD_SET_EMPTY) {
+    bit = 63 - LMath_Clz64(set);
+    set &= ~((card_set_t)1 << bit);
+    array->cards[array->length++] =
+        Card_Make((uint8_t)(((bit & 0x03) + 1) << 4), (uint8_t)((bit >> 2) + 1));
+    array->ranks.n[(bit >> 2) + 1]++;
+  }
+}
+
+/*
+ * ************************************************************
+ * card hand
+ * ************************************************************
+ */
+
+int CardHand_FromArray(card_hand_t* hand, card_array_t* array) {
+  CardHand_Clear(hand);
+
+  if (array->length > CARD_HAND_PRESET_LENGTH)
+    return 0;
+
+  memcpy(hand->cards, array->cards, array->length);
+  hand->length = (uint8_t)array->length;
+
+  return 1;
+}
+
+void CardHand_ToArray(card_hand_t* hand, card_array_t* array) {
+  CardArray_Clear(array);
+  memcpy(array->cards, hand->cards, hand->length);
+  array->length = hand->length;
+  RankCount_Build(&array->ranks, hand->cards, hand->length);
+}
+
+int CardHand_Concat(card_hand_t* head, card_hand_t* tail) {
+  return CardHand_PushBackCards(head, tail->cards, tail->length);
+}
+
+void CardHand_Subtract(card_hand_t* from, card_hand_t* sub) {
+  int i = 0;
+  int length = 0;
+  card_set_t mask = CardSet_FromCards(sub->cards, sub->length);
+
+  for (i = 0; i < from->length; i++) {
+    if (!CardSet_Has(mask, from->cards[i]))
+      from->cards[length++] = from->cards[i];
+  }
+
+  memset(from->cards + length, 0, from->length - length);
+  from->length = (uint8_t)length;
+}
+
+int CardHand_IsContain(card_hand_t* hand, card_hand_t* segment) {
+  if ((hand->length == 0) || (segment->length == 0))
+    return 0;
+
+  if (hand->length < segment->length)
+    return 0;
+
+  return CardSet_IsSubset(CardSet_FromCards(hand->cards, hand->length),
+                          CardSet_FromCards(segment->cards, segment->length))
+             ? 1
+             : 0;
+}
+
+void CardHand_PushBack(card_hand_t* hand, uint8_t card) {
+  if (!CardHand_IsFull(hand))
+    hand->cards[hand->length++] = card;
+}
+
+uint8_t CardHand_PushFront(card_hand_t* hand, uint8_t card) {
+  if (CardHand_IsFull(hand))
+    return 0;
+
+  memmove(hand->cards + 1, hand->cards, hand->length);
+  hand->cards[0] = card;
+  hand->length++;
+
+  return card;
+}
+
+int CardHand_DropFront(card_hand_t* hand, int count) {
+  if (count <= 0)
+    return 0;
+
+  if (count > hand->length)
+    count = hand->length;
+
+  memmove(hand->cards, hand->cards + count, hand->length - count);
+  memset(hand->cards + hand->length - count, 0, count);
+  hand->length -= (uint8_t)count;
+
+  return count;
+}
+
+int CardHand_PushBackCards(card_hand_t* hand, const uint8_t* cards,
+                           int count) {
+  if (count <= 0)
+    return 0;
+
+  if (count > CardHand_Capacity(hand))
+    count = CardHand_Capacity(hand);
+
+  memcpy(hand->cards + hand->length, cards, count);
+  hand->length += (uint8_t)count;
+
+  return count;
+}
+
+void CardHand_CopyRank(card_hand_t* dst, const uint8_t* cards, int length,
+                       uint8_t rank) {
+  int i = 0;
+
+  for (i = 0; i < length; i++) {
+    if (CARD_RANK(cards[i]) == rank)
+      CardHand_PushBack(dst, cards[i]);
+  }
+}
+
+void CardHand_RemoveRank(card_hand_t* hand, uint8_t rank) {
+  int i = 0;
+  int length = 0;
+
+  for (i = 0; i < hand->length; i++) {
+    if (CARD_RANK(hand->cards[i]) != rank)
+      hand->cards[length++] = hand->cards[i];
+  }
+
+  memset(hand->cards + length, 0, hand->length - length);
+  hand->length = (uint8_t)length;
+}
+
+void CardHand_Sort(card_hand_t* hand) {
+  int i = 0;
+  int j = 0;
+  uint8_t card = 0;
+
+  /* a hand is short, insertion sort beats anything fancier */
+  for (i = 1; i < hand->length; i++) {
+    card = hand->cards[i];
+
+    for (j = i; (j > 0) && (CARD_HAND_SORT_KEY(hand->cards[j - 1]) <
+                            CARD_HAND_SORT_KEY(card));
+         j--)
+      hand->cards[j] = hand->cards[j - 1];
+
+    hand->cards[j] = card;
+  }
+}
+
+void CardHand_Reverse(card_hand_t* hand) {
+  int i, j;
+  uint8_t tmp;
+  for (i = 0, j = hand->length - 1; i < hand->length / 2; i++, j--) {
+    tmp = hand->cards[i];
+    hand->cards[i] = hand->cards[j];
+    hand->cards[j] = tmp;
+  }
+}
+
+void CardHand_Print(card_hand_t* hand) {
+  int i = 0;
+  char str[10];
+
+  memset(str, 0, 10);
+  DBGLog("Cards: (%d): ", hand->length);
+
+  for (i = 0; i < hand->length; i++) {
+    Card_ToString(hand->cards[i], str, 10);
+    DBGLog("%s ", str);
+  }
+
+  DBGLog("\n");
+}
+
+int CardArray_ConcatHand(card_array_t* head, card_hand_t* tail) {
+  int i = 0;
+  int length = CARD_SET_LENGTH - head->length;
+
+  if (length > tail->length)
+    length = tail->length;
+
+  for (i = 0; i < length; i++) {
+    head->cards[head->length++] = tail->cards[i];
+    head->ranks.n[CARD_RANK(tail->cards[i])]++;
+  }
+
+  return length < 0 ? 0 : length;
+}
+
+void CardArray_SubtractHand(card_array_t* from, card_hand_t* sub) {
+  _CardArray_SubtractSet(from, CardSet_FromCards(sub->cards, sub->length));
+}
@@ -26,6 +26,7 @@ SOFTWARE.
 #define LANDLORD_CARD_H_
 
 #include "common.h"
+#include "lmath.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -67,6 +68,118 @@ extern "C" {
 
 #define Card_Make(suit, rank) ((suit) | (rank))
 
+/*
+ * ************************************************************
+ * rank count
+ * ************************************************************
+ */
+
+/*
+ * rank count vector, n[rank] is the number of cards of that rank
+ * CARD_RANK_END is 16, so the whole vector fits in one SSE register
+ */
+typedef union _rank_count_u {
+  uint8_t n[CARD_RANK_END];
+  uint64_t q[2];
+
+} rank_count_t;
+
+/* ranks that can chain up, 3 to A */
+#define RANK_MASK_CHAIN (uint16_t)(((1 << CARD_RANK_2) - 1) & ~1)
+
+#define RankCount_Clear(rc) (memset((rc), 0, sizeof(rank_count_t)))
+#define RankCount_Copy(d, s) (memcpy((d), (s), sizeof(rank_count_t)))
+
+/*
+ * count ranks of cards
+ */
+void RankCount_Build(rank_count_t* rc, const uint8_t* cards, int length);
+
+/*
+ * dst = a + b
+ */
+void RankCount_Add(rank_count_t* dst, const rank_count_t* a,
+                   const rank_count_t* b);
+
+/*
+ * dst = a - b, lanes saturate at 0
+ */
+void RankCount_Sub(rank_count_t* dst, const rank_count_t* a,
+                   const rank_count_t* b);
+
+/*
+ * check if two rank counts are identical
+ */
+int RankCount_Equal(const rank_count_t* a, const rank_count_t* b);
+
+/*
+ * check if every lane of a is greater than or equal to b
+ */
+int RankCount_Contain(const rank_count_t* a, const rank_count_t* b);
+
+/*
+ * bit mask of ranks whose count >= k, bit index is rank
+ */
+uint16_t RankCount_MaskGE(const rank_count_t* rc, int k);
+
+/*
+ * bit mask of ranks whose count == k, bit index is rank
+ */
+uint16_t RankCount_MaskEQ(const rank_count_t* rc, int k);
+
+/*
+ * search for the lowest chain of length ranks whose counts are >= k,
+ * the chain must start above rank, returns the start rank or 0
+ */
+int RankCount_FindChain(const rank_count_t* rc, int k, int length, int above);
+
+/*
+ * ************************************************************
+ * rank mask
+ * ************************************************************
+ */
+
+/*
+ * a rank mask has bit n set for rank n, usually RankCount_MaskGE of a
+ * duplicate, a run is a set of consecutive ranks within RANK_MASK_CHAIN
+ */
+
+/* max number of runs in a mask, 3 to A */
+#define RANK_MASK_RUNS 7
+
+/* check if mask is one single run */
+#define RankMask_IsRun(m)                                                      \
+  (((m) != 0) && !((m) & ~RANK_MASK_CHAIN) &&                                  \
+   ((((m) >> LMath_Ctz64(m)) & (((m) >> LMath_Ctz64(m)) + 1)) == 0))
+
+/* number of maximal runs in mask, ranks out of RANK_MASK_CHAIN ignored */
+#define RankMask_RunCount(m)                                                   \
+  LMath_PopCount32(((m) & RANK_MASK_CHAIN) &                                   \
+                   ~(((m) & RANK_MASK_CHAIN) << 1))
+
+/*
+ * bit n of result is set if ranks n .. n + length - 1 are all in mask
+ */
+uint16_t RankMask_RunStarts(uint16_t mask, int length);
+
+/*
+ * lowest run of length ranks that starts above rank,
+ * returns the start rank or 0
+ */
+int RankMask_FindRun(uint16_t mask, int length, int above);
+
+/*
+ * longest run in mask, the lowest one on tie,
+ * returns its length and stores its start rank in low
+ */
+int RankMask_LongestRun(uint16_t mask, int* low);
+
+/*
+ * split mask into maximal runs, highest run first,
+ * stores start ranks in lows and lengths in lengths, returns run count
+ */
+int RankMask_Runs(uint16_t mask, uint8_t* lows, uint8_t* lengths);
+
 /*
  * ************************************************************
  * card array
@@ -76,19 +189,22 @@ extern "C" {
 #define CARD_ARRAY_PRESET_LENGTH CARD_SET_LENGTH
 
 #define CardArray_GetFront(a) ((a)->cards[0])
-#define CardArray_GetBack(a) ((a)->cards[(a)->lenth])
+#define CardArray_GetBack(a) ((a)->cards[(a)->length - 1])
 #define CardArray_Peek(a, i) ((a)->cards[(i)])
 #define CardArray_Clear(a) (memset((a), 0, sizeof(card_array_t)))
 #define CardArray_Copy(d, s) (memcpy((d), (s), sizeof(card_array_t)))
 #define CardArray_IsFull(a) ((a)->length >= CARD_SET_LENGTH)
 #define CardArray_IsEmpty(a) ((a)->length == 0)
 #define CardArray_Capacity(a) (CARD_ARRAY_PRESET_LENGTH - (a)->length)
-#define CardArray_Set(array, where, what, count)                               \
-  (memset((array->cards + where), (what), (count) * sizeof(uint8_t)))
 
+/*
+ * cards must be modified via CardArray_* functions,
+ * so that ranks stays in sync with cards
+ */
 typedef struct _card_arr_s {
   int length;
   uint8_t cards[CARD_ARRAY_PRESET_LENGTH];
+  rank_count_t ranks;
 
 } card_array_t;
 
@@ -111,6 +227,12 @@ void* CardArray_InitFromString(card_array_t* array, const char* str);
  */
 void CardArray_Reset(card_array_t* array);
 
+/*
+ * fill a card array with cards of rank counts, suits are made up,
+ * for code that only reads ranks
+ */
+void CardArray_FromRanks(card_array_t* array, const rank_count_t* ranks);
+
 /**
  * Concatenates two card arrays
  *
@@ -121,19 +243,19 @@ void CardArray_Reset(card_array_t* array);
 int CardArray_Concat(card_array_t* head, card_array_t* tail);
 
 /**
- * remove cards from
+ * remove cards from, order of the rest cards is kept
  * @param from
  * @param sub
  */
 void CardArray_Subtract(card_array_t* from, card_array_t* sub);
 
 /*
- * check for identity
+ * check for identity, card order is ignored
  */
 int CardArray_IsIdentity(card_array_t* a, card_array_t* b);
 
 /*
- * check for contain
+ * check for contain, card order is ignored
  */
 int CardArray_IsContain(card_array_t* array, card_array_t* segment);
 
@@ -199,7 +321,13 @@ void CardArray_CopyRank(card_array_t* dst, card_array_t* src, uint8_t rank);
 void CardArray_RemoveRank(card_array_t* array, uint8_t rank);
 
 /*
- * sort cards
+ * standard comparator, higher rank first then higher suit first
+ */
+int CardArray_StandardSort(const void* a, const void* b);
+
+/*
+ * sort cards, NULL comparator means standard order,
+ * which runs an allocation free counting sort instead of qsort
  */
 void CardArray_Sort(card_array_t* array,
                     int (*comparator)(const void*, const void*));
@@ -219,6 +347,167 @@ void CardArray_Print(card_array_t* array);
  */
 int Card_ToString(uint8_t card, char* buf, int len);
 
+/*
+ * ************************************************************
+ * card set
+ * ************************************************************
+ */
+
+/*
+ * card set is a bitboard with one bit per physical card
+ * bit = (rank - 1) * 4 + (suit - 1), so each rank owns a nibble
+ * and jokers keep their suit, 60 bits are used in total
+ *
+ * | R     | r     | 2     | ... | 4   | 3   |
+ * | 59-56 | 55-52 | 51-48 | ... | 7-4 | 3-0 |
+ *
+ * a card set can not hold the same card twice, which is always true
+ * for cards from a standard 54 card deck
+ */
+typedef uint64_t card_set_t;
+
+#define CARD_SET_EMPTY ((card_set_t)0)
+#define CARD_SET_RANK_SHIFT(rank) (((rank)-1) << 2)
+
+#define CardSet_Bit(card)                                                      \
+  ((card_set_t)1 << (CARD_SET_RANK_SHIFT(CARD_RANK(card)) +                    \
+                     (CARD_SUIT(card) >> 4) - 1))
+#define CardSet_RankMask(rank) ((card_set_t)0x0F << CARD_SET_RANK_SHIFT(rank))
+#define CardSet_Has(set, card) (((set)&CardSet_Bit(card)) != 0)
+#define CardSet_Count(set) LMath_PopCount64(set)
+#define CardSet_CountRank(set, rank)                                           \
+  LMath_PopCount32(((set) >> CARD_SET_RANK_SHIFT(rank)) & 0x0F)
+#define CardSet_IsSubset(set, sub) (((sub) & ~(set)) == 0)
+
+/*
+ * build a card set from card array
+ */
+card_set_t CardSet_FromArray(card_array_t* array);
+
+/*
+ * convert a card set to card array, cards are in standard sort order
+ */
+void CardSet_ToArray(card_set_t set, card_array_t* array);
+
+/*
+ * build a card set from raw cards
+ */
+card_set_t CardSet_FromCards(const uint8_t* cards, int length);
+
+/*
+ * ************************************************************
+ * card hand
+ * ************************************************************
+ */
+
+/*
+ * a hand never holds more than 20 cards, which is also
+ * the most cards a player can hold
+ */
+#define CARD_HAND_PRESET_LENGTH 20
+
+#define CardHand_Clear(h) memset((h), 0, sizeof(card_hand_t))
+#define CardHand_Copy(d, s) memcpy((d), (s), sizeof(card_hand_t))
+#define CardHand_IsFull(h) ((h)->length >= CARD_HAND_PRESET_LENGTH)
+#define CardHand_IsEmpty(h) ((h)->length == 0)
+#define CardHand_Capacity(h) (CARD_HAND_PRESET_LENGTH - (h)->length)
+
+/* swap nibbles so that byte order equals standard order */
+#define CARD_HAND_SORT_KEY(c) ((uint8_t)(((c) << 4) | ((c) >> 4)))
+
+/*
+ * compact card container for hands and search contexts,
+ * one byte length and no rank count, 21 bytes instead of 80
+ */
+typedef struct _card_hand_s {
+  uint8_t length;
+  uint8_t cards[CARD_HAND_PRESET_LENGTH];
+
+} card_hand_t;
+
+/*
+ * copy cards from card array,
+ * return 0 and leave hand empty if there are more than it can hold
+ */
+int CardHand_FromArray(card_hand_t* hand, card_array_t* array);
+
+/*
+ * copy cards to card array
+ */
+void CardHand_ToArray(card_hand_t* hand, card_array_t* array);
+
+/*
+ * concatenates two card hands
+ */
+int CardHand_Concat(card_hand_t* head, card_hand_t* tail);
+
+/*
+ * remove cards from, order of the rest cards is kept
+ */
+void CardHand_Subtract(card_hand_t* from, card_hand_t* sub);
+
+/*
+ * check for contain, card order is ignored
+ */
+int CardHand_IsContain(card_hand_t* hand, card_hand_t* segment);
+
+/*
+ * push a card to the rear of the hand
+ */
+void CardHand_PushBack(card_hand_t* hand, uint8_t card);
+
+/*
+ * push a card to the front of the hand
+ */
+uint8_t CardHand_PushFront(card_hand_t* hand, uint8_t card);
+
+/*
+ * drop multiple cards from the front of the hand
+ */
+int CardHand_DropFront(card_hand_t* hand, int count);
+
+/*
+ * push back count cards, works with both card array and card hand storage
+ */
+int CardHand_PushBackCards(card_hand_t* hand, const uint8_t* cards,
+                           int count);
+
+/*
+ * transfer specific rank cards from raw cards to hand
+ */
+void CardHand_CopyRank(card_hand_t* dst, const uint8_t* cards, int length,
+                       uint8_t rank);
+
+/*
+ * remove specific rank cards from hand
+ */
+void CardHand_RemoveRank(card_hand_t* hand, uint8_t rank);
+
+/*
+ * sort cards in standard order
+ */
+void CardHand_Sort(card_hand_t* hand);
+
+/*
+ * reverse cards
+ */
+void CardHand_Reverse(card_hand_t* hand);
+
+/*
+ * print every card in the hand
+ */
+void CardHand_Print(card_hand_t* hand);
+
+/*
+ * append a card hand to card array
+ */
+int CardArray_ConcatHand(card_array_t* head, card_hand_t* tail);
+
+/*
+ * remove card hand from card array, order of the rest cards is kept
+ */
+void CardArray_SubtractHand(card_array_t* from, card_hand_t* sub);
+
 #ifdef __cplusplus
 }
 #endif
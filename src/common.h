@@ -27,6 +27,12 @@ SOFTWARE.
 
 #define LL_GRAPHICAL_SUIT
 
+/* SSE2 kernels, scalar code is used when not available */
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define LL_SSE2
+#endif
+
 #include <errno.h>
 #include <math.h>
 #include <stdint.h>
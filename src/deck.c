@@ -65,22 +65,13 @@ int Deck_Deal(deck_t* deck, card_array_t* array, int count) {
 
   actualDealt = deck->cards.length >= count ? count : deck->cards.length;
 
-  deck->cards.length -= actualDealt;
-  memcpy(array->cards, &deck->cards.cards[deck->cards.length], actualDealt);
-  array->length = actualDealt;
+  CardArray_PushBackCards(array, &deck->cards,
+                          deck->cards.length - actualDealt, actualDealt);
+  CardArray_DropBack(&deck->cards, actualDealt);
 
   return actualDealt;
 }
 
 int Deck_Recycle(deck_t* deck, card_array_t* array) {
-  int actualRecycled = 0;
-
-  actualRecycled = CardArray_Capacity(&deck->used) < array->length
-                       ? CardArray_Capacity(&deck->used)
-                       : array->length;
-
-  memcpy(&deck->used.cards[deck->used.length], array->cards, actualRecycled);
-  deck->used.length += actualRecycled;
-
-  return actualRecycled;
+  return CardArray_Concat(&deck->used, array);
 }
@@ -0,0 +1,236 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdatomic.h>
+
+#include "evalcache.h"
+#include "evaltable.h"
+
+#define EVAL_CACHE_BUCKET_BITS (EVAL_CACHE_BITS - EVAL_CACHE_WAY_BITS)
+#define EVAL_CACHE_BUCKETS (1 << EVAL_CACHE_BUCKET_BITS)
+
+/* 3 bits per rank lane, lanes 1 .. 15, evaluator sits in unused lane 0 */
+#define EVAL_KEY_LANE_BITS 3
+#define EVAL_KEY_BITS 48
+#define EVAL_KEY_MASK (((uint64_t)1 << EVAL_KEY_BITS) - 1)
+
+/* fibonacci hashing, top bits pick the bucket, the next ones a victim */
+#define EVAL_CACHE_HASH(k) ((k)*0x9E3779B97F4A7C15ull)
+#define EVAL_CACHE_BUCKET(h) ((h) >> (64 - EVAL_CACHE_BUCKET_BITS))
+#define EVAL_CACHE_VICTIM(h)                                                   \
+  (((h) >> (64 - EVAL_CACHE_BITS)) & (EVAL_CACHE_WAYS - 1))
+
+/* counters of a shard, padded to a cache line */
+typedef struct _eval_shard_s {
+  atomic_uint_fast64_t hits;
+  atomic_uint_fast64_t misses;
+  atomic_uint_fast64_t evictions;
+  uint8_t pad[64 - 3 * sizeof(atomic_uint_fast64_t)];
+
+} _eval_shard_t;
+
+/* entry 0 is empty, a key always has its evaluator bits set */
+static _Alignas(64) _Atomic uint64_t _eval_table[EVAL_CACHE_BUCKETS]
+                                                [EVAL_CACHE_WAYS];
+static _Alignas(64) _eval_shard_t _eval_shards[EVAL_CACHE_SHARDS];
+
+eval_key_t EvalCache_Key(const rank_count_t* ranks, int evaluator) {
+  int i = 0;
+  eval_key_t key = 0;
+
+  /* a lane holds at most 4 cards */
+  for (i = CARD_RANK_BEG; i < CARD_RANK_END; i++)
+    key |= (eval_key_t)ranks->n[i] << (i * EVAL_KEY_LANE_BITS);
+
+  return key | (eval_key_t)evaluator;
+}
+
+int EvalCache_Lookup(eval_key_t key, int* value) {
+  int i = 0;
+  uint64_t entry = 0;
+  uint64_t hash = EVAL_CACHE_HASH(key);
+  uint64_t bucket = EVAL_CACHE_BUCKET(hash);
+  _eval_shard_t* shard = &_eval_shards[bucket % EVAL_CACHE_SHARDS];
+
+  /* an entry is self contained, relaxed loads are enough */
+  for (i = 0; i < EVAL_CACHE_WAYS; i++) {
+    entry = atomic_load_explicit(&_eval_table[bucket][i], memory_order_relaxed);
+
+    if ((entry & EVAL_KEY_MASK) == key) {
+      *value = (int)(entry >> EVAL_KEY_BITS);
+      atomic_fetch_add_explicit(&shard->hits, 1, memory_order_relaxed);
+      return 1;
+    }
+  }
+
+  atomic_fetch_add_explicit(&shard->misses, 1, memory_order_relaxed);
+  return 0;
+}
+
+void EvalCache_Store(eval_key_t key, int value) {
+  int i = 0;
+  uint64_t empty = 0;
+  uint64_t entry = 0;
+  uint64_t hash = EVAL_CACHE_HASH(key);
+  uint64_t bucket = EVAL_CACHE_BUCKET(hash);
+  uint64_t store = key | ((uint64_t)value << EVAL_KEY_BITS);
+  _eval_shard_t* shard = &_eval_shards[bucket % EVAL_CACHE_SHARDS];
+
+  /* take a free way, or stop if another thread stored the key */
+  for (i = 0; i < EVAL_CACHE_WAYS; i++) {
+    entry = atomic_load_explicit(&_eval_table[bucket][i], memory_order_relaxed);
+
+    if ((entry & EVAL_KEY_MASK) == key)
+      return;
+
+    if (entry == 0) {
+      empty = 0;
+
+      if (atomic_compare_exchange_strong_explicit(
+              &_eval_table[bucket][i], &empty, store, memory_order_relaxed,
+              memory_order_relaxed))
+        return;
+    }
+  }
+
+  /* bucket full, replace a way picked by the hash */
+  atomic_store_explicit(&_eval_table[bucket][EVAL_CACHE_VICTIM(hash)], store,
+                        memory_order_relaxed);
+  atomic_fetch_add_explicit(&shard->evictions, 1, memory_order_relaxed);
+}
+
+void EvalCache_Clear(void) {
+  int i = 0;
+  int j = 0;
+
+  for (i = 0; i < EVAL_CACHE_BUCKETS; i++) {
+    for (j = 0; j < EVAL_CACHE_WAYS; j++)
+      atomic_store_explicit(&_eval_table[i][j], 0, memory_order_relaxed);
+  }
+
+  for (i = 0; i < EVAL_CACHE_SHARDS; i++) {
+    atomic_store_explicit(&_eval_shards[i].hits, 0, memory_order_relaxed);
+    atomic_store_explicit(&_eval_shards[i].misses, 0, memory_order_relaxed);
+    atomic_store_explicit(&_eval_shards[i].evictions, 0, memory_order_relaxed);
+  }
+}
+
+void EvalCache_Stats(eval_cache_stats_t* stats) {
+  int i = 0;
+
+  memset(stats, 0, sizeof(eval_cache_stats_t));
+
+  for (i = 0; i < EVAL_CACHE_SHARDS; i++) {
+    stats->hits +=
+        atomic_load_explicit(&_eval_shards[i].hits, memory_order_relaxed);
+    stats->misses +=
+        atomic_load_explicit(&_eval_shards[i].misses, memory_order_relaxed);
+    stats->evictions +=
+        atomic_load_explicit(&_eval_shards[i].evictions, memory_order_relaxed);
+  }
+}
+
+void EvalCache_Print(void) {
+  eval_cache_stats_t stats;
+  uint64_t total = 0;
+
+  EvalCache_Stats(&stats);
+  total = stats.hits + stats.misses;
+
+  printf("eval cache : %llu hits, %llu misses, %llu evictions, %.1f%%\n",
+         (unsigned long long)stats.hits, (unsigned long long)stats.misses,
+         (unsigned long long)stats.evictions,
+         total ? (double)stats.hits * 100.0 / (double)total : 0.0);
+}
+
+int EvalCache_StandardEvaluator(card_array_t* array) {
+  int value = 0;
+  eval_key_t key = 0;
+
+  /* precomputed table first, one load */
+  if (EvalTable_Lookup(EVAL_CACHE_STANDARD, &array->ranks, &value))
+    return value;
+
+  key = EvalCache_Key(&array->ranks, EVAL_CACHE_STANDARD);
+
+  if (EvalCache_Lookup(key, &value))
+    return value;
+
+  value = HandList_StandardEvaluator(array);
+  EvalCache_Store(key, value);
+
+  return value;
+}
+
+int EvalCache_AdvancedEvaluator(card_array_t* array) {
+  int value = 0;
+  eval_key_t key = 0;
+
+  /* precomputed table first, one load */
+  if (EvalTable_Lookup(EVAL_CACHE_ADVANCED, &array->ranks, &value))
+    return value;
+
+  key = EvalCache_Key(&array->ranks, EVAL_CACHE_ADVANCED);
+
+  if (EvalCache_Lookup(key, &value))
+    return value;
+
+  value = HandList_AdvancedEvaluator(array);
+  EvalCache_Store(key, value);
+
+  return value;
+}
+
+int EvalCache_StandardEvaluatorDelta(const rank_count_t* ranks,
+                                     const rank_count_t* delta) {
+  rank_count_t left;
+
+  RankCount_Sub(&left, ranks, delta);
+
+  return HandList_StandardEvaluatorRanks(&left);
+}
+
+int EvalCache_AdvancedEvaluatorDelta(const rank_count_t* ranks,
+                                     const rank_count_t* delta) {
+  int value = 0;
+  eval_key_t key = 0;
+  rank_count_t left;
+  card_array_t array;
+
+  RankCount_Sub(&left, ranks, delta);
+
+  if (EvalTable_Lookup(EVAL_CACHE_ADVANCED, &left, &value))
+    return value;
+
+  key = EvalCache_Key(&left, EVAL_CACHE_ADVANCED);
+
+  if (EvalCache_Lookup(key, &value))
+    return value;
+
+  CardArray_FromRanks(&array, &left);
+  value = HandList_AdvancedEvaluator(&array);
+  EvalCache_Store(key, value);
+
+  return value;
+}
@@ -0,0 +1,127 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LANDLORD_EVALCACHE_H_
+#define LANDLORD_EVALCACHE_H_
+
+#include "handlist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * ************************************************************
+ * evaluator cache
+ * ************************************************************
+ */
+
+/*
+ * memo cache for hand evaluators, the evaluators only depend on rank counts
+ *
+ * an entry is one 64 bit word, key in the low 48 bits and value above,
+ * so lookups and stores are single atomic loads and stores and the table
+ * can be shared by threads without locks
+ *
+ * the table is set associative, a key maps to one bucket of
+ * EVAL_CACHE_WAYS entries which fills one cache line, when a bucket is full
+ * a victim picked by the key hash is overwritten
+ */
+
+/* evaluators, part of the key */
+#define EVAL_CACHE_STANDARD 1
+#define EVAL_CACHE_ADVANCED 2
+
+#define EVAL_CACHE_BITS 16 /* 2^16 entries, 512KB */
+#define EVAL_CACHE_WAY_BITS 3
+#define EVAL_CACHE_WAYS (1 << EVAL_CACHE_WAY_BITS)
+#define EVAL_CACHE_SHARDS 16
+
+typedef uint64_t eval_key_t;
+
+typedef struct eval_cache_stats_s {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+
+} eval_cache_stats_t;
+
+/*
+ * canonical key of rank counts for an evaluator
+ */
+eval_key_t EvalCache_Key(const rank_count_t* ranks, int evaluator);
+
+/*
+ * lookup key, return 1 and store value on hit
+ */
+int EvalCache_Lookup(eval_key_t key, int* value);
+
+/*
+ * store value of key
+ */
+void EvalCache_Store(eval_key_t key, int value);
+
+/*
+ * drop all entries and counters, not safe while other threads use the cache
+ */
+void EvalCache_Clear(void);
+
+/*
+ * sum up counters of all shards
+ */
+void EvalCache_Stats(eval_cache_stats_t* stats);
+
+/*
+ * print hit rate
+ */
+void EvalCache_Print(void);
+
+/*
+ * cached HandList_StandardEvaluator, a mapped evaluator table is tried first
+ */
+int EvalCache_StandardEvaluator(card_array_t* array);
+
+/*
+ * cached HandList_AdvancedEvaluator, a mapped evaluator table is tried first
+ */
+int EvalCache_AdvancedEvaluator(card_array_t* array);
+
+/*
+ * standard evaluate ranks minus delta, counting is cheaper than a lookup
+ */
+int EvalCache_StandardEvaluatorDelta(const rank_count_t* ranks,
+                                     const rank_count_t* delta);
+
+/*
+ * cached advanced evaluate ranks minus delta,
+ * cards are only made up from counts when table and cache miss
+ */
+int EvalCache_AdvancedEvaluatorDelta(const rank_count_t* ranks,
+                                     const rank_count_t* delta);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LANDLORD_EVALCACHE_H_ */
@@ -0,0 +1,236 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "evaltable.h"
+
+#define EVAL_TABLE_EVALUATORS (EVAL_CACHE_ADVANCED + 1)
+
+/* cards of a rank, jokers are single */
+#define EVAL_TABLE_LANE_MAX(rank) ((rank) < CARD_RANK_r ? 4 : 1)
+
+/* a mapped table */
+typedef struct _eval_table_s {
+  void* base;
+  size_t size;
+  const uint8_t* values;
+  uint64_t count;
+
+} _eval_table_t;
+
+/*
+ * ways[i][s] is the number of ways ranks i .. R hold s cards,
+ * below[i][s][v] sums ways[i + 1][s - u] for u < v, so the index of a
+ * state is offset[cards] plus below[i][s][n[i]] over ranks, s being the
+ * cards left for ranks i .. R
+ */
+static uint64_t _eval_ways[CARD_RANK_END + 1][EVAL_TABLE_CARDS_MAX + 1];
+static uint64_t _eval_below[CARD_RANK_END][EVAL_TABLE_CARDS_MAX + 1][5];
+static uint64_t _eval_offset[EVAL_TABLE_CARDS_MAX + 2];
+static pthread_once_t _eval_once = PTHREAD_ONCE_INIT;
+
+static _eval_table_t _eval_tables[EVAL_TABLE_EVALUATORS];
+
+void _EvalTable_Build(void) {
+  int i = 0;
+  int s = 0;
+  int v = 0;
+
+  memset(_eval_ways, 0, sizeof(_eval_ways));
+  memset(_eval_below, 0, sizeof(_eval_below));
+  _eval_ways[CARD_RANK_END][0] = 1;
+
+  for (i = CARD_RANK_R; i >= CARD_RANK_BEG; i--) {
+    for (s = 0; s <= EVAL_TABLE_CARDS_MAX; s++) {
+      for (v = 0; v <= EVAL_TABLE_LANE_MAX(i) && v <= s; v++) {
+        _eval_below[i][s][v] = _eval_ways[i][s];
+        _eval_ways[i][s] += _eval_ways[i + 1][s - v];
+      }
+    }
+  }
+
+  _eval_offset[0] = 0;
+
+  for (s = 0; s <= EVAL_TABLE_CARDS_MAX; s++)
+    _eval_offset[s + 1] = _eval_offset[s] + _eval_ways[CARD_RANK_BEG][s];
+}
+
+/* build the rank tables once, any thread may get here first */
+void _EvalTable_Setup(void) { pthread_once(&_eval_once, _EvalTable_Build); }
+
+uint64_t EvalTable_Size(int cards) {
+  _EvalTable_Setup();
+
+  if (cards < 0)
+    return 0;
+
+  if (cards > EVAL_TABLE_CARDS_MAX)
+    cards = EVAL_TABLE_CARDS_MAX;
+
+  return _eval_offset[cards + 1];
+}
+
+int64_t EvalTable_Index(const rank_count_t* ranks) {
+  int i = 0;
+  int s = 0;
+  uint64_t index = 0;
+
+  _EvalTable_Setup();
+
+  for (i = CARD_RANK_BEG; i < CARD_RANK_END; i++) {
+    if (ranks->n[i] > EVAL_TABLE_LANE_MAX(i))
+      return -1;
+
+    s += ranks->n[i];
+  }
+
+  if (s > EVAL_TABLE_CARDS_MAX)
+    return -1;
+
+  index = _eval_offset[s];
+
+  for (i = CARD_RANK_BEG; i < CARD_RANK_END; i++) {
+    index += _eval_below[i][s][ranks->n[i]];
+    s -= ranks->n[i];
+  }
+
+  return (int64_t)index;
+}
+
+int EvalTable_Unrank(uint64_t index, rank_count_t* ranks) {
+  int i = 0;
+  int s = 0;
+  int v = 0;
+
+  _EvalTable_Setup();
+  RankCount_Clear(ranks);
+
+  if (index >= _eval_offset[EVAL_TABLE_CARDS_MAX + 1])
+    return 0;
+
+  while (_eval_offset[s + 1] <= index)
+    s++;
+
+  index -= _eval_offset[s];
+
+  for (i = CARD_RANK_BEG; i < CARD_RANK_END; i++) {
+    for (v = 0; _eval_ways[i + 1][s - v] <= index; v++)
+      index -= _eval_ways[i + 1][s - v];
+
+    ranks->n[i] = (uint8_t)v;
+    s -= v;
+  }
+
+  return 1;
+}
+
+int EvalTable_Open(const char* path) {
+  int fd = -1;
+  void* base = NULL;
+  struct stat st;
+  const eval_table_header_t* header = NULL;
+  _eval_table_t* table = NULL;
+
+  _EvalTable_Setup();
+
+  fd = open(path, O_RDONLY);
+
+  if (fd < 0)
+    return 0;
+
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(eval_table_header_t)) {
+    close(fd);
+    return 0;
+  }
+
+  /* the mapping stays valid after the descriptor is closed */
+  base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (base == MAP_FAILED)
+    return 0;
+
+  header = (const eval_table_header_t*)base;
+
+  if (memcmp(header->magic, EVAL_TABLE_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != EVAL_TABLE_VERSION ||
+      header->evaluator < EVAL_CACHE_STANDARD ||
+      header->evaluator >= EVAL_TABLE_EVALUATORS ||
+      header->cards > EVAL_TABLE_CARDS_MAX ||
+      header->count != EvalTable_Size((int)header->cards) ||
+      (uint64_t)st.st_size - sizeof(eval_table_header_t) < header->count) {
+    munmap(base, (size_t)st.st_size);
+    return 0;
+  }
+
+  table = &_eval_tables[header->evaluator];
+
+  if (table->base != NULL)
+    munmap(table->base, table->size);
+
+  table->base = base;
+  table->size = (size_t)st.st_size;
+  table->values = (const uint8_t*)base + sizeof(eval_table_header_t);
+  table->count = header->count;
+
+  return (int)header->evaluator;
+}
+
+void EvalTable_Close(void) {
+  int i = 0;
+
+  for (i = 0; i < EVAL_TABLE_EVALUATORS; i++) {
+    if (_eval_tables[i].base != NULL)
+      munmap(_eval_tables[i].base, _eval_tables[i].size);
+  }
+
+  memset(_eval_tables, 0, sizeof(_eval_tables));
+}
+
+int EvalTable_Lookup(int evaluator, const rank_count_t* ranks, int* value) {
+  int64_t index = 0;
+  _eval_table_t* table = NULL;
+
+  if (evaluator < EVAL_CACHE_STANDARD || evaluator >= EVAL_TABLE_EVALUATORS)
+    return 0;
+
+  table = &_eval_tables[evaluator];
+
+  if (table->values == NULL)
+    return 0;
+
+  index = EvalTable_Index(ranks);
+
+  if (index < 0 || (uint64_t)index >= table->count)
+    return 0;
+
+  *value = table->values[index];
+
+  return 1;
+}
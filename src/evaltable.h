@@ -0,0 +1,108 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LANDLORD_EVALTABLE_H_
+#define LANDLORD_EVALTABLE_H_
+
+#include "evalcache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * ************************************************************
+ * evaluator table
+ * ************************************************************
+ */
+
+/*
+ * precomputed evaluator values of every rank count with up to
+ * header.cards cards, built offline by tools/evaltable_gen.c and mapped
+ * read only, processes on one box share a single page cache copy
+ *
+ * a state has a dense index, states are ordered by card count, then
+ * lexicographically from rank 3 up, so states with up to n cards are
+ * the first EvalTable_Size(n) entries and a smaller table is a prefix
+ *
+ * the file is a header followed by one byte per state,
+ * states not covered by a table fall back to the evaluator cache
+ */
+
+#define EVAL_TABLE_MAGIC "LLEVTAB"
+#define EVAL_TABLE_VERSION 1
+#define EVAL_TABLE_CARDS_MAX HAND_MAX_LENGTH
+
+/* default file name, one table per evaluator */
+#define EVAL_TABLE_STANDARD_PATH "landlord_standard.evt"
+#define EVAL_TABLE_ADVANCED_PATH "landlord_advanced.evt"
+
+typedef struct eval_table_header_s {
+  char magic[8];
+  uint32_t version;
+  uint32_t evaluator; /* EVAL_CACHE_STANDARD or EVAL_CACHE_ADVANCED */
+  uint32_t cards;     /* states with up to cards cards */
+  uint32_t reserved;
+  uint64_t count; /* number of states */
+
+} eval_table_header_t;
+
+/*
+ * number of states with up to cards cards
+ */
+uint64_t EvalTable_Size(int cards);
+
+/*
+ * dense index of rank counts, -1 if they are not a hand of up to
+ * EVAL_TABLE_CARDS_MAX cards
+ */
+int64_t EvalTable_Index(const rank_count_t* ranks);
+
+/*
+ * rank counts of an index, return 0 if index is out of range
+ */
+int EvalTable_Unrank(uint64_t index, rank_count_t* ranks);
+
+/*
+ * map a table file, return its evaluator or 0 on failure,
+ * a table replaces the one of the same evaluator
+ */
+int EvalTable_Open(const char* path);
+
+/*
+ * unmap all tables
+ */
+void EvalTable_Close(void);
+
+/*
+ * lookup rank counts in the table of evaluator,
+ * return 1 and store value if covered
+ */
+int EvalTable_Lookup(int evaluator, const rank_count_t* ranks, int* value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LANDLORD_EVALTABLE_H_ */
@@ -31,7 +31,8 @@ void Game_Init(game_t* game) {
     Player_SetupStandardAI(&game->players[i]);
     game->players[i].identity = PlayerIdentity_Peasant;
     game->players[i].seatId = i;
-    game->players[i].handlist = NULL;
+    HandList_Clear(&game->players[i].handlist);
+    HandIndex_Build(&game->players[i].handindex, &game->players[i].handlist);
   }
 
   game->bid = 0;
@@ -42,11 +43,12 @@ void Game_Init(game_t* game) {
   game->status = 0;
   game->phase = 0;
 
+  /* seed before the first shuffle, the context is not set up yet */
+  Random_Init(&game->mt, 0);
   Deck_Reset(&game->deck);
   Deck_Shuffle(&game->deck, &game->mt);
   CardArray_Clear(&game->cardRecord);
   CardArray_Clear(&game->kittyCards);
-  Random_Init(&game->mt, 0);
 }
 
 void Game_Clear(game_t* game) {
@@ -160,7 +162,7 @@ void Game_Play(game_t* game, uint32_t seed) {
       game->lastplay = game->playerIndex;
       game->phase = Phase_Query;
 
-      CardArray_Concat(&game->cardRecord, &game->lastHand.cards);
+      CardArray_ConcatHand(&game->cardRecord, &game->lastHand.cards);
 
       DBGLog("\nPlayer ---- %d ---- played\n", game->playerIndex);
       Hand_Print(&game->lastHand);
@@ -180,7 +182,7 @@ void Game_Play(game_t* game, uint32_t seed) {
       } else {
         game->lastplay = game->playerIndex;
         game->phase = Phase_Query;
-        CardArray_Concat(&game->cardRecord, &game->lastHand.cards);
+        CardArray_ConcatHand(&game->cardRecord, &game->lastHand.cards);
 
         DBGLog("\nPlayer ---- %d ---- beat\n", game->playerIndex);
         Hand_Print(&game->lastHand);
@@ -35,22 +35,21 @@ SOFTWARE.
  * solo-chain, pair-chain, trio-chain and four-dual-solo
  *
  * the parse process can be simply describe as
- * 1. rank count            --  count every rank in the card array
- * 2. rank count sort       --  sort the count result
- * 3. pattern match         --  iterate through possible patterns
+ * 1. rank count            --  maintained by card array, no counting needed
+ * 2. signature             --  how many ranks appear once, twice, ... 4 times
+ * 3. table lookup          --  signature indexes a pattern, pattern indexes
+ *                              a recipe with type and distribution
+ *
+ * the sorted rank count of a hand is fully determined by its signature,
+ * for example 333444A2 is sorted as 3311, its signature is (2, 0, 2, 0)
  */
 
 #include "hand.h"
 
-#define HAND_VARIATION 2
-#define HAND_SPEC 4
-
 /* ************************************************************
  * pattern
  * ************************************************************/
 
-#define PATTERN_LENGTH 12
-
 #define HAND_PATTERN_NONE 0  /* place holder */
 #define HAND_PATTERN_1 1     /* 1, solo */
 #define HAND_PATTERN_2_1 2   /* 2, pair */
@@ -83,154 +82,189 @@ SOFTWARE.
 #define HAND_PATTERN_12_5 29 /* four chain */
 #define HAND_PATTERN_12_6 30 /* four dual solo chain */
 #define HAND_PATTERN_14 31   /* pair chain */
-#define HAND_PATTERN_15 32   /* trio chain */
-#define HAND_PATTERN_16_1 33 /* pair chain */
-#define HAND_PATTERN_16_2 34 /* trio solo chain */
-#define HAND_PATTERN_16_3 35 /* four chain */
-#define HAND_PATTERN_16_4 36 /* four dual pair chain */
-#define HAND_PATTERN_18_1 37 /* pair chain */
-#define HAND_PATTERN_18_2 38 /* trio chain */
-#define HAND_PATTERN_18_3 39 /* four dual solo chain */
-#define HAND_PATTERN_20_1 40 /* pair chain */
-#define HAND_PATTERN_20_2 41 /* trio solo chain */
-#define HAND_PATTERN_20_3 42 /* four chain */
-#define HAND_PATTERN_END HAND_PATTERN_20_3
-
-const int _hand_pattern[][PATTERN_LENGTH] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* place holder */
-    {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 1, solo */
-    {2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 2, pair */
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 2, nuke */
-    {3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 3, trio */
-    {4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 4, bomb */
-    {3, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 4, trio solo */
-    {1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0}, /* 5, solo chain */
-    {3, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 5, trio pair */
-    {1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0}, /* 6, solo chain */
-    {2, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 6, pair chain */
-    {3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 6, trio chain */
-    {4, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 6, four dual solo */
-    {1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0}, /* 7, solo chain */
-    {1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0}, /* 8, solo chain */
-    {2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0}, /* 8, pair chain */
-    {3, 3, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0}, /* 8, trio solo chain */
-    {4, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 8, four dual pair */
-    {4, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 8, four chain */
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0}, /* 9, solo chain */
-    {3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 9, trio chain */
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0}, /* 10, solo chain */
-    {2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 0}, /* 10, pair chain */
-    {3, 3, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0}, /* 10, trio pair chain */
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0}, /* 11, solo chain */
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, /* 12, solo chain */
-    {2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0}, /* 12, pair chain */
-    {3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0}, /* 12, trio chain */
-    {3, 3, 3, 1, 1, 1, 0, 0, 0, 0, 0, 0}, /* 12, trio solo chain */
-    {4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0}, /* 12, four chain */
-    {4, 4, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0}, /* 12, four dual solo chain */
-    {2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0}, /* 14, pair chain */
-    {3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0}, /* 15, trio chain */
-    {2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0}, /* 16, pair chain */
-    {3, 3, 3, 3, 1, 1, 1, 1, 0, 0, 0, 0}, /* 16, trio solo chain */
-    {4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0}, /* 16, four chain */
-    {4, 4, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0}, /* 16, four dual pair chain */
-    {2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0}, /* 18, pair chain */
-    {3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0}, /* 18, trio chain */
-    {4, 4, 4, 1, 1, 1, 1, 1, 1, 0, 0, 0}, /* 18, four dual solo chain */
-    {2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0}, /* 20, pair chain */
-    {3, 3, 3, 3, 3, 1, 1, 1, 1, 1, 0, 0}, /* 20, trio solo chain */
-    {4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0}, /* 20, four chain */
+#define HAND_PATTERN_15_1 32 /* trio chain */
+#define HAND_PATTERN_15_2 33 /* trio pair chain */
+#define HAND_PATTERN_16_1 34 /* pair chain */
+#define HAND_PATTERN_16_2 35 /* trio solo chain */
+#define HAND_PATTERN_16_3 36 /* four chain */
+#define HAND_PATTERN_16_4 37 /* four dual pair chain */
+#define HAND_PATTERN_18_1 38 /* pair chain */
+#define HAND_PATTERN_18_2 39 /* trio chain */
+#define HAND_PATTERN_18_3 40 /* four dual solo chain */
+#define HAND_PATTERN_20_1 41 /* pair chain */
+#define HAND_PATTERN_20_2 42 /* trio solo chain */
+#define HAND_PATTERN_20_3 43 /* four chain */
+#define HAND_PATTERN_20_4 44 /* trio pair chain */
+#define HAND_PATTERN_END HAND_PATTERN_20_4
+
+/*
+ * signature (n1, n2, n3, n4), nk is the number of ranks that appear k times
+ * with at most 20 cards: n1 <= 15, n2 <= 10, n3 <= 6, n4 <= 5
+ */
+#define HAND_SIGNATURE_N1 16
+#define HAND_SIGNATURE_N2 11
+#define HAND_SIGNATURE_N3 7
+#define HAND_SIGNATURE_N4 6
+#define HAND_SIGNATURE_END                                                     \
+  (HAND_SIGNATURE_N1 * HAND_SIGNATURE_N2 * HAND_SIGNATURE_N3 * HAND_SIGNATURE_N4)
+
+#define Hand_Signature(n1, n2, n3, n4)                                         \
+  ((((n4)*HAND_SIGNATURE_N3 + (n3)) * HAND_SIGNATURE_N2 + (n2)) *              \
+       HAND_SIGNATURE_N1 +                                                     \
+   (n1))
+
+/* signature to pattern, unlisted signatures are not a hand */
+const uint8_t _hand_signatures[HAND_SIGNATURE_END] = {
+    [Hand_Signature(1, 0, 0, 0)] = HAND_PATTERN_1,
+    [Hand_Signature(0, 1, 0, 0)] = HAND_PATTERN_2_1,
+    [Hand_Signature(2, 0, 0, 0)] = HAND_PATTERN_2_2,
+    [Hand_Signature(0, 0, 1, 0)] = HAND_PATTERN_3,
+    [Hand_Signature(0, 0, 0, 1)] = HAND_PATTERN_4_1,
+    [Hand_Signature(1, 0, 1, 0)] = HAND_PATTERN_4_2,
+    [Hand_Signature(5, 0, 0, 0)] = HAND_PATTERN_5_1,
+    [Hand_Signature(0, 1, 1, 0)] = HAND_PATTERN_5_2,
+    [Hand_Signature(6, 0, 0, 0)] = HAND_PATTERN_6_1,
+    [Hand_Signature(0, 3, 0, 0)] = HAND_PATTERN_6_2,
+    [Hand_Signature(0, 0, 2, 0)] = HAND_PATTERN_6_3,
+    [Hand_Signature(2, 0, 0, 1)] = HAND_PATTERN_6_4,
+    [Hand_Signature(7, 0, 0, 0)] = HAND_PATTERN_7,
+    [Hand_Signature(8, 0, 0, 0)] = HAND_PATTERN_8_1,
+    [Hand_Signature(0, 4, 0, 0)] = HAND_PATTERN_8_2,
+    [Hand_Signature(2, 0, 2, 0)] = HAND_PATTERN_8_3,
+    [Hand_Signature(0, 2, 0, 1)] = HAND_PATTERN_8_4,
+    [Hand_Signature(0, 0, 0, 2)] = HAND_PATTERN_8_5,
+    [Hand_Signature(9, 0, 0, 0)] = HAND_PATTERN_9_1,
+    [Hand_Signature(0, 0, 3, 0)] = HAND_PATTERN_9_2,
+    [Hand_Signature(10, 0, 0, 0)] = HAND_PATTERN_10_1,
+    [Hand_Signature(0, 5, 0, 0)] = HAND_PATTERN_10_2,
+    [Hand_Signature(0, 2, 2, 0)] = HAND_PATTERN_10_3,
+    [Hand_Signature(11, 0, 0, 0)] = HAND_PATTERN_11,
+    [Hand_Signature(12, 0, 0, 0)] = HAND_PATTERN_12_1,
+    [Hand_Signature(0, 6, 0, 0)] = HAND_PATTERN_12_2,
+    [Hand_Signature(0, 0, 4, 0)] = HAND_PATTERN_12_3,
+    [Hand_Signature(3, 0, 3, 0)] = HAND_PATTERN_12_4,
+    [Hand_Signature(0, 0, 0, 3)] = HAND_PATTERN_12_5,
+    [Hand_Signature(4, 0, 0, 2)] = HAND_PATTERN_12_6,
+    [Hand_Signature(0, 7, 0, 0)] = HAND_PATTERN_14,
+    [Hand_Signature(0, 0, 5, 0)] = HAND_PATTERN_15_1,
+    [Hand_Signature(0, 3, 3, 0)] = HAND_PATTERN_15_2,
+    [Hand_Signature(0, 8, 0, 0)] = HAND_PATTERN_16_1,
+    [Hand_Signature(4, 0, 4, 0)] = HAND_PATTERN_16_2,
+    [Hand_Signature(0, 0, 0, 4)] = HAND_PATTERN_16_3,
+    [Hand_Signature(0, 4, 0, 2)] = HAND_PATTERN_16_4,
+    [Hand_Signature(0, 9, 0, 0)] = HAND_PATTERN_18_1,
+    [Hand_Signature(0, 0, 6, 0)] = HAND_PATTERN_18_2,
+    [Hand_Signature(6, 0, 0, 3)] = HAND_PATTERN_18_3,
+    [Hand_Signature(0, 10, 0, 0)] = HAND_PATTERN_20_1,
+    [Hand_Signature(5, 0, 5, 0)] = HAND_PATTERN_20_2,
+    [Hand_Signature(0, 0, 0, 5)] = HAND_PATTERN_20_3,
+    [Hand_Signature(0, 4, 4, 0)] = HAND_PATTERN_20_4,
 };
 
 /**
- *  hand specification contains 5 elements
+ *  hand recipe contains 5 elements
  *  --------------------------------------
- *  pattern
- *  length (contains in card_array_t)
  *  primal
  *  kicker
  *  chain
+ *  d1, count of primal ranks, primal cards are placed first
+ *  d2, count of kicker ranks, kicker cards are placed after primal cards
  *
- *  except solo/pair/trio chains
- *  hands that had same length may have 2 variations at most
+ *  chains require ranks counted d1 times to be consecutive within 3 ~ A
  */
 
-const int _hand_specs[HAND_MAX_LENGTH + 1][HAND_VARIATION][HAND_SPEC] = {
-    {/* place holder */
-     {0, 0, 0, 0},
-     {0, 0, 0, 0}},
-    {/* 1 */
-     {HAND_PATTERN_1, HAND_PRIMAL_SOLO, 0, 0},
-     {0, 0, 0, 0}},
-    {/* 2 */
-     {HAND_PATTERN_2_1, HAND_PRIMAL_PAIR, 0, 0},
-     {0, 0, 0, 0}},
-    {/* 3 */
-     {HAND_PATTERN_3, HAND_PRIMAL_TRIO, 0, 0},
-     {0, 0, 0, 0}},
-    {/* 4 */
-     {HAND_PATTERN_4_2, HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, 0},
-     {0, 0, 0, 0}},
-    {/* 5 */
-     {HAND_PATTERN_5_2, HAND_PRIMAL_TRIO, HAND_KICKER_PAIR, 0},
-     {0, 0, 0, 0}},
-    {/* 6 */
-     {HAND_PATTERN_6_4, HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_SOLO, 0},
-     {0, 0, 0, 0}},
-    {/* 7 */
-     {0, 0, 0, 0},
-     {0, 0, 0, 0}},
-    {/* 8 */
-     {HAND_PATTERN_8_3, HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAIN},
-     {HAND_PATTERN_8_4, HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_PAIR, 0}},
-    {/* 9 */
-     {0, 0, 0, 0},
-     {0, 0, 0, 0}},
-    {/* 10 */
-     {HAND_PATTERN_10_3, HAND_PRIMAL_TRIO, HAND_KICKER_PAIR, HAND_CHAIN},
-     {0, 0, 0, 0}},
-    {/* 11 */
-     {0, 0, 0, 0},
-     {0, 0, 0, 0}},
-    {/* 12 */
-     {HAND_PATTERN_12_4, HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAIN},
-     {HAND_PATTERN_12_6, HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_SOLO, HAND_CHAIN}},
-    {/* 13 */
-     {0, 0, 0, 0},
-     {0, 0, 0, 0}},
-    {/* 14 */
-     {0, 0, 0, 0},
-     {0, 0, 0, 0}},
-    {/* 15 */
-     {0, 0, 0, 0},
-     {0, 0, 0, 0}},
-    {/* 16 */
-     {HAND_PATTERN_16_2, HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAIN},
-     {HAND_PATTERN_16_4, HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_PAIR, HAND_CHAIN}},
-    {/* 17 */
-     {0, 0, 0, 0},
-     {0, 0, 0, 0}},
-    {/* 18 */
-     {HAND_PATTERN_18_3, HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_SOLO, HAND_CHAIN},
-     {0, 0, 0, 0}},
-    {/* 19 */
-     {0, 0, 0, 0},
-     {0, 0, 0, 0}},
-    {/* 20 */
-     {HAND_PATTERN_20_2, HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAIN},
-     {0, 0, 0, 0}}};
+#define HAND_RECIPE 5
+
+const uint8_t _hand_recipes[HAND_PATTERN_END + 1][HAND_RECIPE] = {
+    {0, 0, 0, 0, 0}, /* place holder */
+    {HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAINLESS, 1, 0},
+    {HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAINLESS, 2, 0},
+    {HAND_PRIMAL_NUKE, HAND_KICKER_NONE, HAND_CHAINLESS, 1, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAINLESS, 3, 0},
+    {HAND_PRIMAL_BOMB, HAND_KICKER_NONE, HAND_CHAINLESS, 4, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAINLESS, 3, 1},
+    {HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN, 1, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_PAIR, HAND_CHAINLESS, 3, 2},
+    {HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN, 1, 0},
+    {HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN, 2, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAIN, 3, 0},
+    {HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_SOLO, HAND_CHAINLESS, 4, 1},
+    {HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN, 1, 0},
+    {HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN, 1, 0},
+    {HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN, 2, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAIN, 3, 1},
+    {HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_PAIR, HAND_CHAINLESS, 4, 2},
+    {HAND_PRIMAL_FOUR, HAND_KICKER_NONE, HAND_CHAIN, 4, 0},
+    {HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN, 1, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAIN, 3, 0},
+    {HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN, 1, 0},
+    {HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN, 2, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_PAIR, HAND_CHAIN, 3, 2},
+    {HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN, 1, 0},
+    {HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN, 1, 0},
+    {HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN, 2, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAIN, 3, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAIN, 3, 1},
+    {HAND_PRIMAL_FOUR, HAND_KICKER_NONE, HAND_CHAIN, 4, 0},
+    {HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_SOLO, HAND_CHAIN, 4, 1},
+    {HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN, 2, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAIN, 3, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_PAIR, HAND_CHAIN, 3, 2},
+    {HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN, 2, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAIN, 3, 1},
+    {HAND_PRIMAL_FOUR, HAND_KICKER_NONE, HAND_CHAIN, 4, 0},
+    {HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_PAIR, HAND_CHAIN, 4, 2},
+    {HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN, 2, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAIN, 3, 0},
+    {HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_SOLO, HAND_CHAIN, 4, 1},
+    {HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN, 2, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAIN, 3, 1},
+    {HAND_PRIMAL_FOUR, HAND_KICKER_NONE, HAND_CHAIN, 4, 0},
+    {HAND_PRIMAL_TRIO, HAND_KICKER_PAIR, HAND_CHAIN, 3, 2}};
+
+/* cards per primal rank, indexed by primal */
+const uint8_t _hand_primal_cards[HAND_PRIMAL_NUKE + 1] = {0, 1, 2, 3, 4, 4, 1};
+
+/* kicker ranks per primal rank and cards per kicker rank, by kicker >> 4 */
+const uint8_t _hand_kicker_ranks[5] = {0, 1, 1, 2, 2};
+const uint8_t _hand_kicker_cards[5] = {0, 1, 2, 1, 2};
+
+/* minimum primal ranks of a chain, indexed by primal */
+const uint8_t _hand_chain_ranks[HAND_PRIMAL_FOUR + 1] = {0, 5, 3, 2, 2};
+
+/* every legal hand type */
+#define HAND_TYPES 17
+
+const uint8_t _hand_types[HAND_TYPES] = {
+    Hand_Format(HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_PAIR, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_SOLO, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_PAIR, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_PAIR, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_FOUR, HAND_KICKER_NONE, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_SOLO, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_PAIR, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_BOMB, HAND_KICKER_NONE, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_NUKE, HAND_KICKER_NONE, HAND_CHAINLESS)};
 
 /* ************************************************************
  * hand
  * ************************************************************/
 void Hand_Clear(hand_t* hand) {
-  CardArray_Clear(&hand->cards);
+  CardHand_Clear(&hand->cards);
   hand->type = 0;
 }
 
 void Hand_Copy(hand_t* dst, hand_t* src) {
   dst->type = src->type;
-  CardArray_Copy(&dst->cards, &src->cards);
+  CardHand_Copy(&dst->cards, &src->cards);
 }
 
 /* ************************************************************
@@ -254,10 +288,8 @@ void _Hand_SortCount(int* count) {
 void Hand_CountRank(card_array_t* array, int* count, int* sort) {
   int i = 0;
 
-  memset(count, 0, sizeof(int) * CARD_RANK_END);
-
-  for (i = 0; i < array->length; i++)
-    count[CARD_RANK(array->cards[i])]++;
+  for (i = 0; i < CARD_RANK_END; i++)
+    count[i] = array->ranks.n[i];
 
   if (sort != NULL) {
     memcpy(sort, count, sizeof(int) * CARD_RANK_END);
@@ -265,182 +297,245 @@ void Hand_CountRank(card_array_t* array, int* count, int* sort) {
   }
 }
 
-/* check if a sorted count array matches specific pattern */
-int _Hand_PatternMatch(int* sorted, int pattern) {
-  int ret =
-      memcmp(sorted, _hand_pattern[pattern], sizeof(int) * PATTERN_LENGTH) == 0
-          ? 1
-          : 0;
-
-  return ret;
-}
-
 /*
- * check pattern as 334455 666777 etc
+ * check ranks counted duplicate times are consecutive within 3 ~ A
  * | 666 | 777 | 888 | 999 |
  * | 123 |                   duplicate: 3
- * |  1     2     3     4  | expectLength: 4
  */
-int _Hand_CheckChain(int* count, int duplicate, int expectLength) {
-  int i = 0;
-  int marker = 0;
-  int length = 0;
+int _Hand_CheckChain(const rank_count_t* ranks, int duplicate) {
+  uint16_t mask = RankCount_MaskEQ(ranks, duplicate);
 
   /* joker and 2 can't chain up */
-  for (i = CARD_RANK_3; i < CARD_RANK_2; i++) {
-    /* found first match */
-    if ((count[i] == duplicate) && (marker == 0)) {
-      marker = i;
-      continue;
-    }
-
-    /* matches end */
-    if (((count[i] != duplicate) && (marker != 0))) {
-      length = i - marker;
-      break;
-    }
-  }
-
-  return length == expectLength ? 1 : 0;
+  return RankMask_IsRun(mask) ? 1 : 0;
 }
 
 /*
  * distribute cards
- * for example, _Hand_Distribute(xxx, 88666644, 422, 4, 2, 8)
+ * for example, _Hand_Distribute(xxx, 88666644, 4, 2)
  * hand will be 66668844
  */
-void _Hand_Distribute(hand_t* hand, card_array_t* array, int* count, int d1,
-                      int d2, int length) {
+void _Hand_Distribute(hand_t* hand, card_array_t* array, int d1, int d2) {
   int i = 0;
   int num = 0;
   uint8_t card = 0;
-  card_array_t temp;
+  card_hand_t temp;
 
-  CardArray_Clear(&temp);
+  CardHand_Clear(&temp);
 
   for (i = 0; i < array->length; i++) {
     card = array->cards[i];
-    num = count[CARD_RANK(card)];
+    num = array->ranks.n[CARD_RANK(card)];
 
     if (num == d1)
-      CardArray_PushBack(&hand->cards, card);
+      CardHand_PushBack(&hand->cards, card);
     else if (num == d2)
-      CardArray_PushBack(&temp, card);
-
-    if (hand->cards.length + temp.length >= length) {
-      CardArray_Concat(&hand->cards, &temp);
-      break;
-    }
+      CardHand_PushBack(&temp, card);
   }
+
+  CardHand_Concat(&hand->cards, &temp);
 }
 
-int _Hand_CheckNuke(hand_t* hand, card_array_t* array, int* count,
-                    int* sorted) {
-  int ret = 0;
-  if ((CARD_RANK(array->cards[0]) == CARD_RANK_R) &&
-      (CARD_RANK(array->cards[1]) == CARD_RANK_r)) {
-    hand->type =
-        Hand_Format(HAND_PRIMAL_NUKE, HAND_KICKER_NONE, HAND_CHAINLESS);
-    CardArray_Copy(&hand->cards, array);
-    ret = hand->type;
-  }
+/*
+ * look up the recipe of a rank count, the place holder row if not a hand
+ */
+const uint8_t* _Hand_Recipe(const rank_count_t* ranks, int length) {
+  int n1, n2, n3, n4;
+  const uint8_t* recipe = NULL;
 
-  return ret;
-}
+  /* validate length */
+  if ((length < HAND_MIN_LENGTH) || (length > HAND_MAX_LENGTH))
+    return _hand_recipes[HAND_PATTERN_NONE];
 
-int _Hand_CheckBomb(hand_t* hand, card_array_t* array, int* count,
-                    int* sorted) {
-  int ret = 0;
+  /* signature */
+  n1 = LMath_PopCount32(RankCount_MaskEQ(ranks, 1));
+  n2 = LMath_PopCount32(RankCount_MaskEQ(ranks, 2));
+  n3 = LMath_PopCount32(RankCount_MaskEQ(ranks, 3));
+  n4 = LMath_PopCount32(RankCount_MaskEQ(ranks, 4));
 
-  if (_Hand_PatternMatch(sorted, HAND_PATTERN_4_1)) {
-    /* bomb, 4 */
-    CardArray_Copy(&hand->cards, array);
-    hand->type =
-        Hand_Format(HAND_PRIMAL_BOMB, HAND_KICKER_NONE, HAND_CHAINLESS);
-    ret = hand->type;
-  }
+  /* a rank counted more than 4 times */
+  if (n1 + n2 * 2 + n3 * 3 + n4 * 4 != length)
+    return _hand_recipes[HAND_PATTERN_NONE];
+
+  recipe = _hand_recipes[_hand_signatures[Hand_Signature(n1, n2, n3, n4)]];
+
+  /* nuke must be jokers */
+  if ((recipe[0] == HAND_PRIMAL_NUKE) &&
+      ((ranks->n[CARD_RANK_r] == 0) || (ranks->n[CARD_RANK_R] == 0)))
+    return _hand_recipes[HAND_PATTERN_NONE];
 
-  return ret;
+  if ((recipe[2] == HAND_CHAIN) && !_Hand_CheckChain(ranks, recipe[3]))
+    return _hand_recipes[HAND_PATTERN_NONE];
+
+  return recipe;
 }
 
 int Hand_Parse(hand_t* hand, card_array_t* array) {
-  int count[CARD_RANK_END];
-  int sorted[CARD_RANK_END];
-  int chainlength[HAND_PRIMAL_FOUR + 1] = {
-      0, HAND_SOLO_CHAIN_MIN_LENGTH, HAND_PAIR_CHAIN_MIN_LENGTH,
-      HAND_TRIO_CHAIN_MIN_LENGTH, HAND_FOUR_CHAIN_MIN_LENGTH};
+  const uint8_t* recipe = _Hand_Recipe(&array->ranks, array->length);
+
+  /* clear hand */
+  Hand_Clear(hand);
+
+  if (recipe[0] == HAND_PRIMAL_NONE)
+    return HAND_NONE;
 
   /* sort cards */
   CardArray_Sort(array, NULL);
 
-  /* count ranks */
-  Hand_CountRank(array, count, sorted);
+  if (recipe[1] == HAND_KICKER_NONE)
+    CardHand_FromArray(&hand->cards, array);
+  else
+    _Hand_Distribute(hand, array, recipe[3], recipe[4]);
 
-  /* clear hand */
-  Hand_Clear(hand);
+  hand->type = Hand_Format(recipe[0], recipe[1], recipe[2]);
 
-  do {
-    int i = 0;
+  return hand->type;
+}
 
-    /* validate length */
-    if ((array->length < HAND_MIN_LENGTH) ||
-        (array->length > HAND_MAX_LENGTH)) {
-      hand->type = HAND_NONE;
-      break;
-    }
+int Hand_Classify(const card_array_t* array) {
+  const uint8_t* recipe = _Hand_Recipe(&array->ranks, array->length);
 
-    /* nuke */
-    if ((array->length == 2) && _Hand_CheckNuke(hand, array, count, sorted)) {
-      break;
-    }
+  return Hand_Format(recipe[0], recipe[1], recipe[2]);
+}
 
-    /* bomb */
-    if ((array->length == 4) && _Hand_CheckBomb(hand, array, count, sorted)) {
-      break;
-    }
+void Hand_ClassifyBatch(const card_array_t* arrays, int count,
+                        uint8_t* types) {
+  int i = 0;
+  const uint8_t* recipe = NULL;
+
+  for (i = 0; i < count; i++) {
+    recipe = _Hand_Recipe(&arrays[i].ranks, arrays[i].length);
+    types[i] = Hand_Format(recipe[0], recipe[1], recipe[2]);
+  }
+}
+
+/*
+ * read cards as type, see Hand_ParseAs
+ * primal ranks need count >= d1, cards left over become kickers,
+ * one kicker per rank and none on a primal rank
+ */
+int _Hand_ParseAs(hand_t* hand, const card_array_t* array, int type) {
+  int i = 0;
+  int lead = 0;
+  int primal = Hand_GetPrimal(type);
+  int kicker = Hand_GetKicker(type) >> 4;
+  int d1 = _hand_primal_cards[primal];
+  int unit = d1 + _hand_kicker_ranks[kicker] * _hand_kicker_cards[kicker];
+  int chain = 0;
+  uint16_t mask = 0;
+  uint16_t run = 0;
+  uint8_t need[CARD_RANK_END];
+  rank_count_t left;
+  card_array_t sorted;
+  card_hand_t kickers;
+
+  if ((array->length % unit) != 0)
+    return HAND_NONE;
+
+  chain = array->length / unit;
+
+  if (Hand_GetChain(type) ? (chain < _hand_chain_ranks[primal]) : (chain != 1))
+    return HAND_NONE;
+
+  mask = RankCount_MaskGE(&array->ranks, d1);
+
+  if (Hand_GetChain(type))
+    mask &= RANK_MASK_CHAIN;
+
+  /* highest primal run first */
+  for (lead = CARD_RANK_END - 1; lead >= chain; lead--) {
+    run = (uint16_t)(((1 << chain) - 1) << (lead - chain + 1));
+
+    if ((mask & run) != run)
+      continue;
 
-    /* chains */
-    for (i = 1; i < HAND_PRIMAL_FOUR + 1; i++) {
-      int chainMinLength = chainlength[i];
-      if ((array->length >= chainMinLength) && (array->length % i == 0) &&
-          _Hand_CheckChain(count, i, array->length / i)) {
-        hand->type = Hand_Format(i, HAND_KICKER_NONE, HAND_CHAIN);
-        CardArray_Copy(&hand->cards, array);
-        break;
-      }
+    /* kickers take distinct ranks off the primal run, as Hand_Parse */
+    if (kicker != 0) {
+      RankCount_Copy(&left, &array->ranks);
+
+      for (i = lead - chain + 1; i <= lead; i++)
+        left.n[i] -= (uint8_t)d1;
+
+      if ((RankCount_MaskGE(&left, 1) & run) ||
+          (RankCount_MaskGE(&left, 1) !=
+           RankCount_MaskEQ(&left, _hand_kicker_cards[kicker])))
+        continue;
     }
 
-    /* chain or other type */
-    if (hand->type != 0) {
-      break;
+    break;
+  }
+
+  if (lead < chain)
+    return HAND_NONE;
+
+  /* distribute, primal cards first */
+  memset(need, 0, sizeof(need));
+
+  for (i = lead - chain + 1; i <= lead; i++)
+    need[i] = (uint8_t)d1;
+
+  CardArray_Copy(&sorted, array);
+  CardArray_Sort(&sorted, NULL);
+  CardHand_Clear(&kickers);
+
+  for (i = 0; i < sorted.length; i++) {
+    if (need[CARD_RANK(sorted.cards[i])]) {
+      need[CARD_RANK(sorted.cards[i])]--;
+      CardHand_PushBack(&hand->cards, sorted.cards[i]);
     } else {
-      int pattern, primal, kicker, chain, d1;
-      int d2[] = {0, 1, 2, 1, 2};
-
-      for (i = 0; i < 2; i++) {
-        pattern = _hand_specs[array->length][i][0];
-        primal = _hand_specs[array->length][i][1];
-        kicker = _hand_specs[array->length][i][2];
-        chain = _hand_specs[array->length][i][3];
-
-        if (pattern == 0) {
-          hand->type = 0;
-          break;
-        }
-
-        if (_Hand_PatternMatch(sorted, pattern)) {
-          d1 = primal;
-          _Hand_Distribute(hand, array, count, d1, d2[kicker >> 4],
-                           array->length);
-          hand->type = Hand_Format(primal, kicker, chain);
-          break;
-        }
-      }
+      CardHand_PushBack(&kickers, sorted.cards[i]);
     }
+  }
 
-  } while (0);
+  CardHand_Concat(&hand->cards, &kickers);
+  hand->type = (uint8_t)type;
 
-  return hand->type;
+  return type;
+}
+
+int Hand_ParseAs(hand_t* hand, const card_array_t* array, int type) {
+  int i = 0;
+
+  Hand_Clear(hand);
+
+  if ((array->length < HAND_MIN_LENGTH) || (array->length > HAND_MAX_LENGTH))
+    return HAND_NONE;
+
+  for (i = 0; (i < HAND_TYPES) && (_hand_types[i] != type); i++)
+    ;
+
+  if (i == HAND_TYPES)
+    return HAND_NONE;
+
+  /* nuke is the only hand made of two ranks with one card each */
+  if (type == HAND_PRIMAL_NUKE) {
+    if ((array->length != 2) || !array->ranks.n[CARD_RANK_r] ||
+        !array->ranks.n[CARD_RANK_R])
+      return HAND_NONE;
+
+    hand->type = HAND_PRIMAL_NUKE;
+    CardHand_CopyRank(&hand->cards, array->cards, 2, CARD_RANK_R);
+    CardHand_CopyRank(&hand->cards, array->cards, 2, CARD_RANK_r);
+    return type;
+  }
+
+  return _Hand_ParseAs(hand, array, type);
+}
+
+int Hand_ParseAll(const card_array_t* array, hand_t* hands, int capacity) {
+  int i = 0;
+  int count = 0;
+  hand_t hand;
+
+  for (i = 0; i < HAND_TYPES; i++) {
+    if (Hand_ParseAs(&hand, array, _hand_types[i]) != HAND_NONE) {
+      if (count < capacity)
+        Hand_Copy(&hands[count], &hand);
+
+      count++;
+    }
+  }
+
+  return count;
 }
 
 /*
@@ -449,56 +544,26 @@ int Hand_Parse(hand_t* hand, card_array_t* array) {
  * ************************************************************
  */
 
-/* one of a, b must be bomb or nuke */
-int _Hand_CompareBomb(hand_t* a, hand_t* b) {
-  int ret = HAND_CMP_ILLEGAL;
+hand_key_t Hand_Key(hand_t* hand) {
+  int tier = (hand->type == HAND_PRIMAL_NUKE) * HAND_KEY_TIER_NUKE +
+             (hand->type == HAND_PRIMAL_BOMB) * HAND_KEY_TIER_BOMB;
 
-  /* same type same cards, equal */
-  if ((a->type == b->type) && (a->cards.cards[0] == b->cards.cards[0]))
-    ret = HAND_CMP_EQUAL;
+  return Hand_KeyMake(tier, hand->type, hand->cards.length,
+                      CARD_RANK(hand->cards.cards[0]));
+}
 
-  /* both are bombs, compare by card rank */
-  else if ((a->type == HAND_PRIMAL_BOMB) && (b->type == HAND_PRIMAL_BOMB))
-    ret = CARD_RANK(a->cards.cards[0]) > CARD_RANK(b->cards.cards[0])
-              ? HAND_CMP_GREATER
-              : HAND_CMP_LESS;
-  else
-    ret = Hand_GetPrimal(a->type) > Hand_GetPrimal(b->type) ? HAND_CMP_GREATER
-                                                            : HAND_CMP_LESS;
+int Hand_CompareKey(hand_key_t a, hand_key_t b) {
+  hand_key_t diff = a ^ b;
+  int sign = (a > b) - (a < b);
 
-  return ret;
+  /* same type and length, or bomb/nuke against anything else */
+  int illegal = ((diff >> 8) != 0) & ((diff >> 24) == 0);
+
+  return sign + ((HAND_CMP_ILLEGAL - sign) & -illegal);
 }
 
 int Hand_Compare(hand_t* a, hand_t* b) {
-  int result = HAND_CMP_ILLEGAL;
-
-  /*
-   * different hand type
-   * check for bomb and nuke
-   */
-  if (a->type != b->type) {
-    if ((a->type != HAND_PRIMAL_NUKE) && (a->type != HAND_PRIMAL_BOMB) &&
-        (b->type != HAND_PRIMAL_NUKE) && (b->type != HAND_PRIMAL_BOMB))
-      result = HAND_CMP_ILLEGAL;
-    else
-      result = _Hand_CompareBomb(a, b);
-  } else /* same hand type and with no bombs */
-  {
-    /* same hand type but different length */
-    if (a->cards.length != b->cards.length) {
-      result = HAND_CMP_ILLEGAL;
-    } else /* same hand type and same length */
-    {
-      if (CARD_RANK(a->cards.cards[0]) == CARD_RANK(b->cards.cards[0]))
-        result = HAND_CMP_EQUAL;
-      else
-        result = CARD_RANK(a->cards.cards[0]) > CARD_RANK(b->cards.cards[0])
-                     ? HAND_CMP_GREATER
-                     : HAND_CMP_LESS;
-    }
-  }
-
-  return result;
+  return Hand_CompareKey(Hand_Key(a), Hand_Key(b));
 }
 
 void Hand_Print(hand_t* hand) {
@@ -580,5 +645,147 @@ void Hand_Print(hand_t* hand) {
 
   DBGLog("]\n");
 
-  CardArray_Print(&hand->cards);
+  CardHand_Print(&hand->cards);
+}
+
+/*
+ * ************************************************************
+ * rank hand
+ * ************************************************************
+ */
+
+int RankHand_FromHand(rank_hand_t* rh, hand_t* hand) {
+  int i = 0;
+  int dup = _hand_primal_cards[Hand_GetPrimal(hand->type)];
+  int kicker = Hand_GetKicker(hand->type) >> 4;
+  int unit = dup + _hand_kicker_ranks[kicker] * _hand_kicker_cards[kicker];
+  int rank = 0;
+
+  RankHand_Clear(rh);
+
+  if (unit == 0)
+    return 0;
+
+  rh->type = hand->type;
+
+  if (hand->type == HAND_PRIMAL_NUKE) {
+    rh->rank = CARD_RANK_R;
+    rh->chain = 1;
+    return 1;
+  }
+
+  rh->chain = (uint8_t)(hand->cards.length / unit);
+
+  for (i = 0; i < hand->cards.length; i++) {
+    rank = CARD_RANK(hand->cards.cards[i]);
+
+    if (i < rh->chain * dup) {
+      if (rank > rh->rank)
+        rh->rank = (uint8_t)rank;
+    } else {
+      rh->kicker |= (uint16_t)(1 << rank);
+    }
+  }
+
+  /* a kicker rank repeated would be lost in the mask */
+  if (LMath_PopCount32(rh->kicker) != rh->chain * _hand_kicker_ranks[kicker]) {
+    RankHand_Clear(rh);
+    return 0;
+  }
+
+  return 1;
+}
+
+/* take count lowest suits of rank from set, 0 if not enough */
+int _RankHand_Take(hand_t* hand, card_set_t* set, int rank, int count) {
+  int bit = 0;
+  card_set_t suits = *set & CardSet_RankMask(rank);
+
+  if (LMath_PopCount64(suits) < count)
+    return 0;
+
+  while (count--) {
+    bit = LMath_Ctz64(suits);
+    suits &= suits - 1;
+    *set &= ~((card_set_t)1 << bit);
+    CardHand_PushBack(&hand->cards,
+                      Card_Make((uint8_t)(((bit & 0x03) + 1) << 4), rank));
+  }
+
+  return 1;
+}
+
+int RankHand_ToHand(rank_hand_t* rh, hand_t* hand, const uint8_t* cards,
+                    int length) {
+  int i = 0;
+  int ok = (rh->type != HAND_NONE);
+  int dup = _hand_primal_cards[Hand_GetPrimal(rh->type)];
+  int kicker = _hand_kicker_cards[Hand_GetKicker(rh->type) >> 4];
+  card_set_t set = CardSet_FromCards(cards, length);
+
+  Hand_Clear(hand);
+  hand->type = rh->type;
+
+  if (rh->type == HAND_PRIMAL_NUKE) {
+    ok = _RankHand_Take(hand, &set, CARD_RANK_R, 1) &&
+         _RankHand_Take(hand, &set, CARD_RANK_r, 1);
+  } else {
+    for (i = rh->rank; ok && (i > rh->rank - rh->chain); i--)
+      ok = _RankHand_Take(hand, &set, i, dup);
+
+    for (i = CARD_RANK_END - 1; ok && (i > 0); i--) {
+      if (rh->kicker & (1 << i))
+        ok = _RankHand_Take(hand, &set, i, kicker);
+    }
+  }
+
+  /* a kicker mask short of ranks leaves slots empty */
+  if (ok && hand->cards.length != RankHand_Length(rh))
+    ok = 0;
+
+  if (!ok)
+    Hand_Clear(hand);
+
+  return ok;
+}
+
+int RankHand_Length(rank_hand_t* rh) {
+  int dup = _hand_primal_cards[Hand_GetPrimal(rh->type)];
+  int kicker = Hand_GetKicker(rh->type) >> 4;
+
+  if (rh->type == HAND_PRIMAL_NUKE)
+    return 2;
+
+  /* what the type needs, whatever the kicker mask holds */
+  return rh->chain *
+         (dup + _hand_kicker_ranks[kicker] * _hand_kicker_cards[kicker]);
+}
+
+void RankHand_Count(rank_hand_t* rh, rank_count_t* count) {
+  int i = 0;
+  int dup = _hand_primal_cards[Hand_GetPrimal(rh->type)];
+  int kicker = _hand_kicker_cards[Hand_GetKicker(rh->type) >> 4];
+
+  RankCount_Clear(count);
+
+  if (rh->type == HAND_PRIMAL_NUKE) {
+    count->n[CARD_RANK_r] = 1;
+    count->n[CARD_RANK_R] = 1;
+    return;
+  }
+
+  for (i = rh->rank; i > rh->rank - rh->chain; i--)
+    count->n[i] = (uint8_t)dup;
+
+  for (i = CARD_RANK_BEG; i < CARD_RANK_END; i++) {
+    if (rh->kicker & (1 << i))
+      count->n[i] = (uint8_t)kicker;
+  }
+}
+
+hand_key_t RankHand_Key(rank_hand_t* rh) {
+  int tier = (rh->type == HAND_PRIMAL_NUKE) * HAND_KEY_TIER_NUKE +
+             (rh->type == HAND_PRIMAL_BOMB) * HAND_KEY_TIER_BOMB;
+
+  return Hand_KeyMake(tier, rh->type, RankHand_Length(rh), rh->rank);
 }
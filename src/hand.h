@@ -88,7 +88,7 @@ typedef enum {
  */
 typedef struct _hand_s {
   uint8_t type;
-  card_array_t cards;
+  card_hand_t cards;
 
 } hand_t;
 
@@ -108,20 +108,139 @@ void Hand_Copy(hand_t* dst, hand_t* src);
 void Hand_CountRank(card_array_t* array, int* count, int* sort);
 
 /*
- * parse a card array to hand
+ * parse a card array to hand, cards in array are sorted only when they
+ * parse as a hand, an array that is no hand is left as it was
  */
 int Hand_Parse(hand_t* hand, card_array_t* array);
 
+/*
+ * read a card array as the given hand type, array is not modified
+ * return type on success, HAND_NONE if the cards can not be read as type
+ *
+ * kickers follow the Hand_Parse rule, distinct ranks other than the
+ * primal ranks, so 333344, 33344455 and 33334444 read as trio solo chain
+ * are not readings, and every reading has a move id. when several primal
+ * runs fit, the highest is taken
+ */
+int Hand_ParseAs(hand_t* hand, const card_array_t* array, int type);
+
+/*
+ * every reading of a card array, one per hand type
+ * up to capacity hands are stored, return the number of readings
+ *
+ * with kickers held to the Hand_Parse rule no card set is known to have
+ * more than one reading, 33334444 reads only as four chain, so in practice
+ * this gives at most one hand, don't build on several interpretations
+ */
+int Hand_ParseAll(const card_array_t* array, hand_t* hands, int capacity);
+
+/*
+ * hand type of a card array, array is not modified
+ * only the maintained rank count is read, so no sorting is involved
+ */
+int Hand_Classify(const card_array_t* array);
+
+/*
+ * classify count card arrays at once, types[i] is the type of arrays[i]
+ */
+void Hand_ClassifyBatch(const card_array_t* arrays, int count,
+                        uint8_t* types);
+
 /*
  * compare two hands
  */
 int Hand_Compare(hand_t* a, hand_t* b);
 
+/*
+ * hand key packs everything a comparison needs into 32 bits
+ * | tier  | type  | length | lead rank |
+ * | 31-24 | 23-16 | 15-8   | 7-0       |
+ *
+ * tier is 2 for nuke, 1 for bomb and 0 for the rest, so hands are
+ * comparable when the tiers differ or when the upper 24 bits are equal,
+ * and then the integer order is the hand order
+ */
+typedef uint32_t hand_key_t;
+
+#define HAND_KEY_TIER_NORMAL 0
+#define HAND_KEY_TIER_BOMB 1
+#define HAND_KEY_TIER_NUKE 2
+
+#define Hand_KeyMake(tier, type, length, rank)                                 \
+  (((hand_key_t)(tier) << 24) | ((hand_key_t)(type) << 16) |                   \
+   ((hand_key_t)(length) << 8) | (hand_key_t)(rank))
+#define Hand_KeyTier(k) ((int)((k) >> 24))
+#define Hand_KeyType(k) ((uint8_t)((k) >> 16))
+#define Hand_KeyLength(k) ((int)(((k) >> 8) & 0xFF))
+#define Hand_KeyRank(k) ((int)((k)&0xFF))
+
+/*
+ * build the key of a hand
+ */
+hand_key_t Hand_Key(hand_t* hand);
+
+/*
+ * compare two hand keys without branches, same result as Hand_Compare
+ */
+int Hand_CompareKey(hand_key_t a, hand_key_t b);
+
 /*
  * hand print
  */
 void Hand_Print(hand_t* hand);
 
+/*
+ * ************************************************************
+ * rank hand
+ * ************************************************************
+ */
+
+/*
+ * rank level hand, suits are not stored
+ * primal ranks are rank - chain + 1 ~ rank, kicker ranks are bits in kicker
+ * a nuke is stored as rank R with chain 1
+ */
+typedef struct _rank_hand_s {
+  uint8_t type;
+  uint8_t rank;    /* lead rank, the highest primal rank */
+  uint8_t chain;   /* number of primal ranks, 1 for chainless hands */
+  uint8_t pad;     /* reserved */
+  uint16_t kicker; /* kicker rank mask, bit n for rank n */
+
+} rank_hand_t;
+
+#define RankHand_Clear(rh) memset((rh), 0, sizeof(rank_hand_t))
+#define RankHand_Copy(d, s) memcpy((d), (s), sizeof(rank_hand_t))
+
+/*
+ * convert a hand to rank hand, return 0 and clear rh if the hand has
+ * fewer kicker ranks than its type needs, the mask would drop cards
+ */
+int RankHand_FromHand(rank_hand_t* rh, hand_t* hand);
+
+/*
+ * materialize a rank hand with cards taken from cards,
+ * lowest suits are taken first, primal ranks go first, higher rank first
+ * return 0 if cards can not provide the hand or rh doesn't fill its type
+ */
+int RankHand_ToHand(rank_hand_t* rh, hand_t* hand, const uint8_t* cards,
+                    int length);
+
+/*
+ * number of cards in a rank hand, as its type and chain need
+ */
+int RankHand_Length(rank_hand_t* rh);
+
+/*
+ * rank counts of the cards in a rank hand
+ */
+void RankHand_Count(rank_hand_t* rh, rank_count_t* count);
+
+/*
+ * build the key of a rank hand, same as Hand_Key of its hand
+ */
+hand_key_t RankHand_Key(rank_hand_t* rh);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,82 +27,270 @@ SOFTWARE.
  * add handlist_sort
  */
 
+#include <pthread.h>
+#include <stdatomic.h>
+
 #include "handlist.h"
+#include "evalcache.h"
 #include "lmath.h"
+#include "move.h"
 
-#define BEAT_NODE_CAPACITY 255
+#ifdef LL_SSE2
+#include <emmintrin.h>
+#endif
 
 /*
  * ************************************************************
  * hand list
  * ************************************************************
  */
-void HandList_PushFront(rk_list_t* hl, hand_t* hand) {
-  hand_t* payload = (hand_t*)malloc(sizeof(hand_t));
-  Hand_Copy(payload, hand);
-  rk_list_push(hl, payload);
+int HandList_PushBack(hand_list_t* hl, hand_t* hand) {
+  if (HandList_IsFull(hl))
+    return 0;
+
+  Hand_Copy(&hl->hands[hl->length++], hand);
+
+  return 1;
 }
 
-void HandList_Remove(rk_list_t* hl, hand_t* hand) {
-  void* payload = NULL;
-  rk_list_foreach(hl, first, next, cur) {
-    if (cur->payload == hand) {
-      payload = rk_list_remove(hl, cur);
-      break;
-    }
-  }
+void HandList_Concat(hand_list_t* dst, hand_list_t* src) {
+  int length = src->length;
 
-  free(payload);
+  if (length > HAND_LIST_CAPACITY - dst->length)
+    length = HAND_LIST_CAPACITY - dst->length;
+
+  memcpy(dst->hands + dst->length, src->hands, sizeof(hand_t) * length);
+  dst->length += length;
 }
 
-int _HandList_FindFunc(void* payload, void* context) {
-  return ((hand_t*)payload)->type == *(int*)context ? 1 : 0;
+void HandList_RemoveAt(hand_list_t* hl, int where) {
+  if (where < 0 || where >= hl->length)
+    return;
+
+  memmove(hl->hands + where, hl->hands + where + 1,
+          sizeof(hand_t) * (hl->length - where - 1));
+  hl->length--;
 }
 
-hand_t* HandList_Find(rk_list_t* hl, int handtype) {
-  return rk_list_search(hl, &handtype, _HandList_FindFunc);
+void HandList_SwapRemove(hand_list_t* hl, int where) {
+  if (where < 0 || where >= hl->length)
+    return;
+
+  if (where != --hl->length)
+    Hand_Copy(&hl->hands[where], &hl->hands[hl->length]);
+}
+
+void HandList_Remove(hand_list_t* hl, hand_t* hand) {
+  HandList_RemoveAt(hl, (int)(hand - hl->hands));
+}
+
+hand_t* HandList_Find(hand_list_t* hl, int handtype) {
+  int i = 0;
+
+  for (i = 0; i < hl->length; i++) {
+    if (hl->hands[i].type == handtype)
+      return &hl->hands[i];
+  }
+
+  return NULL;
 }
 
 /*
  * ************************************************************
- * beat search
+ * hand index
  * ************************************************************
  */
 
-/* beat search context */
-typedef struct hand_ctx_s {
-  /* rank count */
-  int count[CARD_RANK_END];
-  /* original cards */
-  card_array_t cards;
-  /* reverse sorted cards */
-  card_array_t rcards;
+/* link hand at where into its bucket, above hands of the same lead */
+void _HandIndex_Link(hand_index_t* index, hand_list_t* hl, int where) {
+  uint8_t type = hl->hands[where].type;
+  int lead = HandIndex_Lead(&hl->hands[where]);
+  uint8_t above = HAND_INDEX_NONE;
+  uint8_t below = index->highest[type];
+
+  while (below != HAND_INDEX_NONE && HandIndex_Lead(&hl->hands[below]) > lead) {
+    above = below;
+    below = index->lower[below];
+  }
+
+  index->lower[where] = below;
+  index->higher[where] = above;
+
+  if (below != HAND_INDEX_NONE)
+    index->higher[below] = (uint8_t)where;
+  else
+    index->lowest[type] = (uint8_t)where;
+
+  if (above != HAND_INDEX_NONE)
+    index->lower[above] = (uint8_t)where;
+  else
+    index->highest[type] = (uint8_t)where;
+
+  index->count[type]++;
+}
+
+void _HandIndex_Unlink(hand_index_t* index, hand_list_t* hl, int where) {
+  uint8_t type = hl->hands[where].type;
+  uint8_t below = index->lower[where];
+  uint8_t above = index->higher[where];
+
+  if (below != HAND_INDEX_NONE)
+    index->higher[below] = above;
+  else
+    index->lowest[type] = above;
+
+  if (above != HAND_INDEX_NONE)
+    index->lower[above] = below;
+  else
+    index->highest[type] = below;
+
+  index->count[type]--;
+}
+
+void HandIndex_Build(hand_index_t* index, hand_list_t* hl) {
+  int i = 0;
+
+  memset(index->count, 0, sizeof(index->count));
+  memset(index->lowest, HAND_INDEX_NONE, sizeof(index->lowest));
+  memset(index->highest, HAND_INDEX_NONE, sizeof(index->highest));
+
+  /* later hands go below earlier ones of the same lead */
+  for (i = hl->length - 1; i >= 0; i--)
+    _HandIndex_Link(index, hl, i);
+}
+
+hand_t* HandIndex_Lowest(hand_index_t* index, hand_list_t* hl, int type) {
+  uint8_t where = index->lowest[(uint8_t)type];
+
+  return where != HAND_INDEX_NONE ? &hl->hands[where] : NULL;
+}
+
+hand_t* HandIndex_Highest(hand_index_t* index, hand_list_t* hl, int type) {
+  uint8_t where = index->highest[(uint8_t)type];
+
+  return where != HAND_INDEX_NONE ? &hl->hands[where] : NULL;
+}
+
+/* positions above where move up by one */
+#define HandIndex_Shift(p, where)                                              \
+  ((p) != HAND_INDEX_NONE && (p) > (where) ? (uint8_t)((p) - 1) : (p))
 
-} hand_ctx_t;
+void HandIndex_Remove(hand_index_t* index, hand_list_t* hl, hand_t* hand) {
+  int i = 0;
+  int where = (int)(hand - hl->hands);
+
+  if (where < 0 || where >= hl->length)
+    return;
+
+  _HandIndex_Unlink(index, hl, where);
+  HandList_RemoveAt(hl, where);
 
-#define HandCtx_Clear(ctx) memset((ctx), 0, sizeof(hand_ctx_t))
+  memmove(index->lower + where, index->lower + where + 1,
+          (size_t)(hl->length - where));
+  memmove(index->higher + where, index->higher + where + 1,
+          (size_t)(hl->length - where));
 
-void HandCtx_Setup(hand_ctx_t* ctx, card_array_t* array) {
+  for (i = 0; i < hl->length; i++) {
+    index->lower[i] = HandIndex_Shift(index->lower[i], where);
+    index->higher[i] = HandIndex_Shift(index->higher[i], where);
+  }
+
+  for (i = 0; i < HAND_INDEX_TYPES; i++) {
+    index->lowest[i] = HandIndex_Shift(index->lowest[i], where);
+    index->highest[i] = HandIndex_Shift(index->highest[i], where);
+  }
+}
+
+/*
+ * ************************************************************
+ * beat search
+ * ************************************************************
+ */
+
+/*
+ * ************************************************************
+ * search context
+ * ************************************************************
+ */
+
+int HandCtx_Setup(hand_ctx_t* ctx, card_array_t* array) {
   /* setup search context */
   HandCtx_Clear(ctx);
 
-  Hand_CountRank(array, ctx->count, NULL);
-  CardArray_Copy(&ctx->cards, array);
-  CardArray_Copy(&ctx->rcards, array);
-  CardArray_Sort(&ctx->cards, NULL);
-  CardArray_Reverse(&ctx->rcards);
+  /* counts must not promise cards the context can't hold */
+  if (!CardHand_FromArray(&ctx->cards, array))
+    return 0;
+
+  RankCount_Copy(&ctx->count, &array->ranks);
+  CardHand_Sort(&ctx->cards);
+  CardHand_Copy(&ctx->rcards, &ctx->cards);
+  CardHand_Reverse(&ctx->rcards);
+
+  return 1;
+}
+
+void HandCtx_Remove(hand_ctx_t* ctx, card_hand_t* hand) {
+  int i = 0;
+  card_set_t mask = CardSet_FromCards(hand->cards, hand->length);
+
+  /* count what is really removed, a hand may repeat a card */
+  for (i = 0; i < ctx->cards.length; i++) {
+    if (CardSet_Has(mask, ctx->cards.cards[i]))
+      ctx->count.n[CARD_RANK(ctx->cards.cards[i])]--;
+  }
+
+  /* removing keeps both views ordered */
+  CardHand_Subtract(&ctx->cards, hand);
+  CardHand_Subtract(&ctx->rcards, hand);
 }
 
+void HandCtx_Add(hand_ctx_t* ctx, card_hand_t* hand) {
+  int i = 0;
+  int j = 0;
+  int length = 0;
+  uint8_t card = 0;
+  card_hand_t* cards = &ctx->cards;
+  card_hand_t* rcards = &ctx->rcards;
+
+  for (i = 0; (i < hand->length) && !CardHand_IsFull(cards); i++) {
+    card = hand->cards[i];
+    length = cards->length;
+
+    /* insert into sorted cards, higher rank and suit first */
+    for (j = length; (j > 0) && (CARD_HAND_SORT_KEY(cards->cards[j - 1]) <
+                                 CARD_HAND_SORT_KEY(card));
+         j--)
+      cards->cards[j] = cards->cards[j - 1];
+
+    cards->cards[j] = card;
+    cards->length++;
+
+    /* rcards mirrors cards */
+    memmove(rcards->cards + length - j + 1, rcards->cards + length - j,
+            (size_t)j);
+    rcards->cards[length - j] = card;
+    rcards->length++;
+
+    ctx->count.n[CARD_RANK(card)]++;
+  }
+}
+
+/*
+ * ************************************************************
+ * beat search
+ * ************************************************************
+ */
+
 int _HandList_SearchBeat_Primal(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat,
                                 int primal) {
   int i = 0;
   int canbeat = 0;
-  int* count = NULL;
+  uint8_t* count = NULL;
   int rank = 0;
-  card_array_t* temp = NULL;
+  card_hand_t* temp = NULL;
   int tobeattype = tobeat->type;
 
-  count = ctx->count;
+  count = ctx->count.n;
   temp = &ctx->rcards;
 
   rank = CARD_RANK(tobeat->cards.cards[0]);
@@ -113,7 +301,7 @@ int _HandList_SearchBeat_Primal(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat,
     if ((CARD_RANK(temp->cards[i]) > rank) && c >= primal) {
       Hand_Clear(beat);
       beat->type = (uint8_t)tobeattype;
-      CardArray_PushBackCards(&beat->cards, temp, i, primal);
+      CardHand_PushBackCards(&beat->cards, temp->cards + i, primal);
       canbeat = 1;
       break;
     }
@@ -125,11 +313,11 @@ int _HandList_SearchBeat_Primal(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat,
 
 int _HandList_SearchBeat_Bomb(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat) {
   int canbeat = 0;
-  int* count = NULL;
+  uint8_t* count = NULL;
   int i = 0;
-  card_array_t* cards = &ctx->cards;
+  card_hand_t* cards = &ctx->cards;
 
-  count = ctx->count;
+  count = ctx->count.n;
 
   /* can't beat nuke */
   if (tobeat->type ==
@@ -146,7 +334,8 @@ int _HandList_SearchBeat_Bomb(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat) {
       if (c == 4) {
         canbeat = 1;
         Hand_Clear(beat);
-        CardArray_CopyRank(&beat->cards, cards, CARD_RANK(ctx->cards.cards[i]));
+        CardHand_CopyRank(&beat->cards, cards->cards, cards->length,
+                          CARD_RANK(cards->cards[i]));
         break;
       }
       i += c;
@@ -160,8 +349,10 @@ int _HandList_SearchBeat_Bomb(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat) {
       Hand_Clear(beat);
       beat->type =
           Hand_Format(HAND_PRIMAL_NUKE, HAND_KICKER_NONE, HAND_CHAINLESS);
-      CardArray_CopyRank(&beat->cards, cards, CARD_RANK_R);
-      CardArray_CopyRank(&beat->cards, cards, CARD_RANK_r);
+      CardHand_CopyRank(&beat->cards, cards->cards, cards->length,
+                        CARD_RANK_R);
+      CardHand_CopyRank(&beat->cards, cards->cards, cards->length,
+                        CARD_RANK_r);
     }
   } else {
     beat->type =
@@ -188,8 +379,8 @@ int _HandList_SearchBeat_TrioKicker(hand_ctx_t* ctx, hand_t* tobeat,
   int canbeat = 0;
   int cantriobeat = 0;
   int tobeattype = tobeat->type;
-  int* count = NULL;
-  card_array_t temp;
+  uint8_t* count = NULL;
+  card_hand_t temp;
   hand_t htrio, hkick, htriobeat, hkickbeat;
 
   Hand_Clear(&htrio);
@@ -197,18 +388,18 @@ int _HandList_SearchBeat_TrioKicker(hand_ctx_t* ctx, hand_t* tobeat,
   Hand_Clear(&htriobeat);
   Hand_Clear(&hkickbeat);
 
-  count = ctx->count;
-  CardArray_Copy(&temp, &ctx->rcards);
+  count = ctx->count.n;
+  CardHand_Copy(&temp, &ctx->rcards);
 
   /* copy hands */
-  CardArray_PushBackCards(&htrio.cards, &tobeat->cards, 0, 3);
-  CardArray_PushBackCards(&hkick.cards, &tobeat->cards, 3, kick);
+  CardHand_PushBackCards(&htrio.cards, tobeat->cards.cards, 3);
+  CardHand_PushBackCards(&hkick.cards, tobeat->cards.cards + 3, kick);
 
   /* same rank trio , case b */
-  if (CardArray_IsContain(&temp, &htrio.cards)) {
+  if (CardHand_IsContain(&temp, &htrio.cards)) {
     /* keep trio beat */
-    CardArray_Copy(&htriobeat.cards, &htrio.cards);
-    CardArray_RemoveRank(&temp, CARD_RANK(htriobeat.cards.cards[0]));
+    CardHand_Copy(&htriobeat.cards, &htrio.cards);
+    CardHand_RemoveRank(&temp, CARD_RANK(htriobeat.cards.cards[0]));
 
     /* search for a higher kicker */
     /* round 1: only search those count[rank] == kick */
@@ -216,8 +407,8 @@ int _HandList_SearchBeat_TrioKicker(hand_ctx_t* ctx, hand_t* tobeat,
       int c = count[CARD_RANK(temp.cards[i])];
       if (c >= kick &&
           CARD_RANK(temp.cards[i]) > CARD_RANK(hkick.cards.cards[0])) {
-        CardArray_Clear(&hkickbeat.cards);
-        CardArray_PushBackCards(&hkickbeat.cards, &temp, i, kick);
+        CardHand_Clear(&hkickbeat.cards);
+        CardHand_PushBackCards(&hkickbeat.cards, temp.cards + i, kick);
         canbeat = 1;
         break;
       }
@@ -226,8 +417,8 @@ int _HandList_SearchBeat_TrioKicker(hand_ctx_t* ctx, hand_t* tobeat,
 
     /* if kicker can't beat, restore trio */
     if (canbeat == 0) {
-      CardArray_Clear(&htriobeat.cards);
-      CardArray_Copy(&temp, &ctx->rcards);
+      CardHand_Clear(&htriobeat.cards);
+      CardHand_Copy(&temp, &ctx->rcards);
     }
   }
 
@@ -243,13 +434,13 @@ int _HandList_SearchBeat_TrioKicker(hand_ctx_t* ctx, hand_t* tobeat,
     /* trio beat found, search for kicker beat */
     if (cantriobeat == 1) {
       /* remove trio from temp */
-      CardArray_RemoveRank(&temp, CARD_RANK(htriobeat.cards.cards[0]));
+      CardHand_RemoveRank(&temp, CARD_RANK(htriobeat.cards.cards[0]));
 
       /* search for a kicker */
       for (i = 0; i < temp.length;) {
         int c = count[CARD_RANK(temp.cards[i])];
         if (c >= kick) {
-          CardArray_PushBackCards(&hkickbeat.cards, &temp, i, kick);
+          CardHand_PushBackCards(&hkickbeat.cards, temp.cards + i, kick);
           canbeat = 1;
           break;
         }
@@ -261,8 +452,8 @@ int _HandList_SearchBeat_TrioKicker(hand_ctx_t* ctx, hand_t* tobeat,
   /* beat */
   if (canbeat == 1) {
     Hand_Clear(beat);
-    CardArray_Concat(&beat->cards, &htriobeat.cards);
-    CardArray_Concat(&beat->cards, &hkickbeat.cards);
+    CardHand_Concat(&beat->cards, &htriobeat.cards);
+    CardHand_Concat(&beat->cards, &hkickbeat.cards);
     beat->type = (uint8_t)tobeattype;
   }
 
@@ -273,55 +464,42 @@ int _HandList_SearchBeat_Chain(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat,
                                int duplicate) {
   int canbeat = 0;
   int found = 0;
-  int i, j, k, chainlength;
+  int i, k, chainlength;
   int tobeattype = tobeat->type;
   uint8_t footer = 0;
-  int* count = NULL;
-  card_array_t* cards = &ctx->cards;
-  card_array_t temp;
+  card_hand_t* cards = &ctx->cards;
+  card_hand_t temp;
 
-  count = ctx->count;
-  CardArray_Clear(&temp);
+  CardHand_Clear(&temp);
 
   chainlength = tobeat->cards.length / duplicate;
   footer = CARD_RANK(tobeat->cards.cards[tobeat->cards.length - 1]);
 
   /* search for beat chain in rank counts */
-  for (i = footer + 1; i <= CARD_RANK_2 - chainlength; i++) {
-    found = 1;
-
-    for (j = 0; j < chainlength; j++) {
-      /* check if chain breaks */
-      if (count[i + j] < duplicate) {
-        found = 0;
-        break;
-      }
-    }
-
-    if (found) {
-      footer = i;    /* beat footer rank */
-      k = duplicate; /* how many cards needed for each rank */
+  i = RankCount_FindChain(&ctx->count, duplicate, chainlength, footer);
+  found = i != 0 ? 1 : 0;
 
-      for (i = cards->length; i >= 0 && chainlength > 0; i--) {
-        if (CARD_RANK(cards->cards[i]) == footer) {
-          CardArray_PushFront(&temp, cards->cards[i]);
-          k--;
-
-          if (k == 0) {
-            k = duplicate;
-            chainlength--;
-            footer++;
-          }
+  if (found) {
+    footer = (uint8_t)i; /* beat footer rank */
+    k = duplicate;       /* how many cards needed for each rank */
+
+    for (i = cards->length - 1; i >= 0 && chainlength > 0; i--) {
+      if (CARD_RANK(cards->cards[i]) == footer) {
+        CardHand_PushFront(&temp, cards->cards[i]);
+        k--;
+
+        if (k == 0) {
+          k = duplicate;
+          chainlength--;
+          footer++;
         }
       }
-
-      break;
     }
   }
 
   if (found) {
     beat->type = (uint8_t)tobeattype;
-    CardArray_Copy(&beat->cards, &temp);
+    CardHand_Copy(&beat->cards, &temp);
     canbeat = 1;
   }
 
@@ -334,38 +512,38 @@ int _HandList_SearchBeat_TrioKickerChain(hand_ctx_t* ctx, hand_t* tobeat,
   int cantriobeat = 0;
   int i, j, chainlength;
   int tobeattype = tobeat->type;
-  int count[CARD_RANK_END];
-  int kickcount[CARD_RANK_END];
+  uint8_t count[CARD_RANK_END];
+  uint8_t kickcount[CARD_RANK_END];
   int combrankmap[CARD_RANK_END];
   int rankcombmap[CARD_RANK_END];
   int comb[CARD_RANK_END];
-  card_array_t temp;
+  card_hand_t temp;
   hand_t htrio, hkick, htriobeat, hkickbeat;
 
   /* setup variables */
-  memcpy(count, ctx->count, sizeof(int) * CARD_RANK_END);
+  memcpy(count, ctx->count.n, sizeof(count));
 
   Hand_Clear(&htrio);
   Hand_Clear(&hkick);
   Hand_Clear(&htriobeat);
   Hand_Clear(&hkickbeat);
 
-  CardArray_Copy(&temp, &ctx->rcards);
+  CardHand_Copy(&temp, &ctx->rcards);
   chainlength = tobeat->cards.length / (HAND_PRIMAL_TRIO + kc);
 
   /* copy tobeat cards */
-  CardArray_PushBackCards(&htrio.cards, &tobeat->cards, 0, 3 * chainlength);
-  CardArray_PushBackCards(&hkick.cards, &tobeat->cards, 3 * chainlength,
-                          chainlength * kc);
+  CardHand_PushBackCards(&htrio.cards, tobeat->cards.cards, 3 * chainlength);
+  CardHand_PushBackCards(&hkick.cards, tobeat->cards.cards + 3 * chainlength,
+                         chainlength * kc);
 
   htrio.type = Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAIN);
 
   /* self beat, see _HandList_SearchBeat_TrioKicker */
-  if (CardArray_IsContain(&temp, &htrio.cards)) {
+  if (CardHand_IsContain(&temp, &htrio.cards)) {
     int n = 0; /* combination total */
 
     /* remove trio from kickcount */
-    memcpy(kickcount, count, sizeof(int) * CARD_RANK_END);
+    memcpy(kickcount, count, sizeof(kickcount));
 
     for (i = 0; i < htrio.cards.length; i += 3)
       kickcount[CARD_RANK(htrio.cards.cards[i])] = 0;
@@ -406,7 +584,7 @@ int _HandList_SearchBeat_TrioKickerChain(hand_ctx_t* ctx, hand_t* tobeat,
 
         for (j = 0; j < temp.length; j++) {
           if (CARD_RANK(temp.cards[j]) == rank) {
-            CardArray_PushBackCards(&hkickbeat.cards, &temp, j, kc);
+            CardHand_PushBackCards(&hkickbeat.cards, temp.cards + j, kc);
             break;
           }
         }
@@ -415,15 +593,15 @@ int _HandList_SearchBeat_TrioKickerChain(hand_ctx_t* ctx, hand_t* tobeat,
       canbeat = 1;
 
       /* copy trio to beat */
-      CardArray_Concat(&htriobeat.cards, &htrio.cards);
-      CardArray_Sort(&hkickbeat.cards, NULL);
+      CardHand_Concat(&htriobeat.cards, &htrio.cards);
+      CardHand_Sort(&hkickbeat.cards);
     }
   }
 
   /* can't find same rank trio chain, search for higher rank trio */
   if (canbeat == 0) {
     /* restore rank count */
-    memcpy(count, ctx->count, sizeof(int) * CARD_RANK_END);
+    memcpy(count, ctx->count.n, sizeof(count));
 
     cantriobeat = _HandList_SearchBeat_Chain(ctx, &htrio, &htriobeat, 3);
 
@@ -431,15 +609,15 @@ int _HandList_SearchBeat_TrioKickerChain(hand_ctx_t* ctx, hand_t* tobeat,
     if (cantriobeat) {
       /* remove trio from temp */
       for (i = 0; i < htriobeat.cards.length; i += 3) {
-        CardArray_RemoveRank(&temp, CARD_RANK(htriobeat.cards.cards[i]));
+        CardHand_RemoveRank(&temp, CARD_RANK(htriobeat.cards.cards[i]));
         count[CARD_RANK(htriobeat.cards.cards[0])] = 0;
       }
 
       for (j = 0; j < chainlength; j++) {
         for (i = 0; i < temp.length; i++) {
           if (count[CARD_RANK(temp.cards[i])] >= kc) {
-            CardArray_PushBackCards(&hkickbeat.cards, &temp, i, kc);
-            CardArray_RemoveRank(&temp, CARD_RANK(temp.cards[i]));
+            CardHand_PushBackCards(&hkickbeat.cards, temp.cards + i, kc);
+            CardHand_RemoveRank(&temp, CARD_RANK(temp.cards[i]));
             break;
           }
         }
@@ -453,68 +631,68 @@ int _HandList_SearchBeat_TrioKickerChain(hand_ctx_t* ctx, hand_t* tobeat,
   /* final */
   if (canbeat) {
     Hand_Clear(beat);
-    CardArray_Concat(&beat->cards, &htriobeat.cards);
-    CardArray_Concat(&beat->cards, &hkickbeat.cards);
+    CardHand_Concat(&beat->cards, &htriobeat.cards);
+    CardHand_Concat(&beat->cards, &hkickbeat.cards);
     beat->type = (uint8_t)tobeattype;
   }
 
   return canbeat;
 }
 
-int _HandList_SearchBeat(card_array_t* cards, hand_t* tobeat, hand_t* beat) {
+/*
+ * search a beat of the same type, no bomb/nuke fallback
+ * ctx->cards must be sorted, ctx->rcards reversed and ctx->count in sync
+ */
+int _HandList_SearchBeatType(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat) {
   int canbeat = 0;
-  hand_ctx_t ctx;
-
-  /* setup search context */
-  HandCtx_Setup(&ctx, cards);
 
   /* start search */
   switch (tobeat->type) {
   case Hand_Format(HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAINLESS):
-    canbeat = _HandList_SearchBeat_Primal(&ctx, tobeat, beat, HAND_PRIMAL_SOLO);
+    canbeat = _HandList_SearchBeat_Primal(ctx, tobeat, beat, HAND_PRIMAL_SOLO);
     break;
 
   case Hand_Format(HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAINLESS):
-    canbeat = _HandList_SearchBeat_Primal(&ctx, tobeat, beat, HAND_PRIMAL_PAIR);
+    canbeat = _HandList_SearchBeat_Primal(ctx, tobeat, beat, HAND_PRIMAL_PAIR);
     break;
 
   case Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAINLESS):
-    canbeat = _HandList_SearchBeat_Primal(&ctx, tobeat, beat, HAND_PRIMAL_TRIO);
+    canbeat = _HandList_SearchBeat_Primal(ctx, tobeat, beat, HAND_PRIMAL_TRIO);
     break;
 
   case Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_PAIR, HAND_CHAINLESS):
     canbeat =
-        _HandList_SearchBeat_TrioKicker(&ctx, tobeat, beat, HAND_PRIMAL_PAIR);
+        _HandList_SearchBeat_TrioKicker(ctx, tobeat, beat, HAND_PRIMAL_PAIR);
     break;
 
   case Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAINLESS):
     canbeat =
-        _HandList_SearchBeat_TrioKicker(&ctx, tobeat, beat, HAND_PRIMAL_SOLO);
+        _HandList_SearchBeat_TrioKicker(ctx, tobeat, beat, HAND_PRIMAL_SOLO);
     break;
 
   case Hand_Format(HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN):
-    canbeat = _HandList_SearchBeat_Chain(&ctx, tobeat, beat, HAND_PRIMAL_SOLO);
+    canbeat = _HandList_SearchBeat_Chain(ctx, tobeat, beat, HAND_PRIMAL_SOLO);
     break;
 
   case Hand_Format(HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN):
-    canbeat = _HandList_SearchBeat_Chain(&ctx, tobeat, beat, HAND_PRIMAL_PAIR);
+    canbeat = _HandList_SearchBeat_Chain(ctx, tobeat, beat, HAND_PRIMAL_PAIR);
     break;
 
   case Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAIN):
-    canbeat = _HandList_SearchBeat_Chain(&ctx, tobeat, beat, HAND_PRIMAL_TRIO);
+    canbeat = _HandList_SearchBeat_Chain(ctx, tobeat, beat, HAND_PRIMAL_TRIO);
     break;
 
   case Hand_Format(HAND_PRIMAL_FOUR, HAND_KICKER_NONE, HAND_CHAIN):
-    canbeat = _HandList_SearchBeat_Chain(&ctx, tobeat, beat, HAND_PRIMAL_FOUR);
+    canbeat = _HandList_SearchBeat_Chain(ctx, tobeat, beat, HAND_PRIMAL_FOUR);
     break;
 
   case Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_PAIR, HAND_CHAIN):
-    canbeat = _HandList_SearchBeat_TrioKickerChain(&ctx, tobeat, beat,
+    canbeat = _HandList_SearchBeat_TrioKickerChain(ctx, tobeat, beat,
                                                    HAND_PRIMAL_PAIR);
     break;
 
   case Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAIN):
-    canbeat = _HandList_SearchBeat_TrioKickerChain(&ctx, tobeat, beat,
+    canbeat = _HandList_SearchBeat_TrioKickerChain(ctx, tobeat, beat,
                                                    HAND_PRIMAL_SOLO);
     break;
 
@@ -522,13 +700,32 @@ int _HandList_SearchBeat(card_array_t* cards, hand_t* tobeat, hand_t* beat) {
     break;
   }
 
+  return canbeat;
+}
+
+/*
+ * search a beat, fall back to bomb/nuke
+ */
+int _HandList_SearchBeatCtx(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat) {
+  int canbeat = _HandList_SearchBeatType(ctx, tobeat, beat);
+
   /* search for bomb/nuke */
   if (canbeat == 0)
-    canbeat = _HandList_SearchBeat_Bomb(&ctx, tobeat, beat);
+    canbeat = _HandList_SearchBeat_Bomb(ctx, tobeat, beat);
 
   return canbeat;
 }
 
+int _HandList_SearchBeat(card_array_t* cards, hand_t* tobeat, hand_t* beat) {
+  hand_ctx_t ctx;
+
+  /* setup search context */
+  if (!HandCtx_Setup(&ctx, cards))
+    return 0;
+
+  return _HandList_SearchBeatCtx(&ctx, tobeat, beat);
+}
+
 /*
  * search for beat, result will be store in beat
  * 1, if [beat->type] != 0, then search [new beat] > [beat]
@@ -542,26 +739,48 @@ int HandList_SearchBeat(card_array_t* cards, hand_t* tobeat, hand_t* beat) {
     return _HandList_SearchBeat(cards, tobeat, beat);
 }
 
-rk_list_t* HandList_SearchBeatList(card_array_t* cards, hand_t* tobeat) {
-  rk_list_t* hl = NULL;
-  hand_t htobeat;
+int HandList_CanBeat(card_array_t* cards, hand_t* tobeat) {
+  rank_hand_t rh;
   hand_t beat;
-  int canbeat = 0;
 
-  Hand_Clear(&beat);
-  Hand_Copy(&htobeat, tobeat);
+  RankHand_FromHand(&rh, tobeat);
 
-  hl = rk_list_create();
-  do {
-    canbeat = _HandList_SearchBeat(cards, &htobeat, &beat);
+  /* not a move id, let the search decide */
+  if (Move_FromRankHand(&rh) == MOVE_NONE) {
+    Hand_Clear(&beat);
+    return HandList_SearchBeat(cards, tobeat, &beat);
+  }
 
-    if (canbeat) {
-      Hand_Copy(&htobeat, &beat);
-      HandList_PushFront(hl, &beat);
-    }
-  } while (canbeat);
+  return Move_CanBeat(&cards->ranks, &rh);
+}
 
-  return hl;
+int HandList_SearchBeatCtx(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat) {
+  /* already in search loop, continue */
+  if (beat->type != 0)
+    return _HandList_SearchBeatCtx(ctx, beat, beat);
+  else
+    return _HandList_SearchBeatCtx(ctx, tobeat, beat);
+}
+
+void HandList_SearchBeatList(card_array_t* cards, hand_t* tobeat,
+                             hand_list_t* beats) {
+  hand_ctx_t ctx;
+
+  /* one context serves the whole loop, an empty one finds nothing */
+  HandCtx_Setup(&ctx, cards);
+  HandList_SearchBeatListCtx(&ctx, tobeat, beats);
+}
+
+void HandList_SearchBeatListCtx(hand_ctx_t* ctx, hand_t* tobeat,
+                                hand_list_t* beats) {
+  beat_iter_t iter;
+  hand_t beat;
+
+  HandList_Clear(beats);
+  BeatIter_Init(&iter, ctx, tobeat, NULL, 0);
+
+  while (!HandList_IsFull(beats) && BeatIter_Next(&iter, &beat))
+    HandList_PushBack(beats, &beat);
 }
 
 /*
@@ -574,13 +793,15 @@ rk_list_t* HandList_SearchBeatList(card_array_t* cards, hand_t* tobeat) {
  * extract hands like 34567 / 334455 / 333444555 etc
  * array is a processed card array holds count[rank] == duplicate
  */
-void _HandList_ExtractConsecutive(rk_list_t* hl, card_array_t* array,
+void _HandList_ExtractConsecutive(hand_list_t* hl, card_array_t* array,
                                   int duplicate) {
   int i = 0;
   int j = 0;
   int k = 0;
-  int cardnum = 0;
-  uint8_t lastrank = 0;
+  int n = 0;
+  int runs = 0;
+  uint8_t lows[RANK_MASK_RUNS];
+  uint8_t lengths[RANK_MASK_RUNS];
   hand_t hand;
   int primal[] = {0, HAND_PRIMAL_SOLO, HAND_PRIMAL_PAIR, HAND_PRIMAL_TRIO};
   int chainlen[] = {0, HAND_SOLO_CHAIN_MIN_LENGTH, HAND_PAIR_CHAIN_MIN_LENGTH,
@@ -589,80 +810,41 @@ void _HandList_ExtractConsecutive(rk_list_t* hl, card_array_t* array,
   if ((duplicate < 1) || (duplicate > 3) || (array->length == 0))
     return;
 
-  Hand_Clear(&hand);
-
-  cardnum = array->length / duplicate - 1;
-  lastrank = CARD_RANK(array->cards[0]);
-  i = duplicate;
-
-  while (cardnum--) {
-    if ((lastrank - 1) != CARD_RANK(array->cards[i])) {
-      /* chain break */
-      if (i >= chainlen[duplicate]) {
-        /* chain */
-        Hand_Clear(&hand);
-        hand.type =
-            Hand_Format(primal[duplicate], HAND_KICKER_NONE, HAND_CHAIN);
-
-        for (j = 0; j < i; j++)
-          CardArray_PushBack(&hand.cards, CardArray_PopFront(array));
-
-        HandList_PushFront(hl, &hand);
-      } else {
-        /* not a chain */
-        for (j = 0; j < i / duplicate; j++) {
-          Hand_Clear(&hand);
-          hand.type =
-              Hand_Format(primal[duplicate], HAND_KICKER_NONE, HAND_CHAINLESS);
-
-          for (k = 0; k < duplicate; k++)
-            CardArray_PushBack(&hand.cards, CardArray_PopFront(array));
-
-          HandList_PushFront(hl, &hand);
-        }
-      }
-
-      if (array->length == 0)
-        break;
+  /* array is sorted, so runs come off its front highest first */
+  runs = RankMask_Runs(RankCount_MaskGE(&array->ranks, duplicate), lows,
+                       lengths);
 
-      lastrank = CARD_RANK(array->cards[0]);
-      i = duplicate;
-    } else {
-      /* chain intact */
-      lastrank = CARD_RANK(array->cards[i]);
-      i += duplicate;
-    }
-  }
+  for (i = 0; i < runs; i++) {
+    n = lengths[i] * duplicate;
 
-  /* all chained up */
-  if ((i != 0) && (i == array->length)) {
-    /* can chain up */
-    if (i >= chainlen[duplicate]) {
+    if (n >= chainlen[duplicate]) {
+      /* chain */
       Hand_Clear(&hand);
       hand.type = Hand_Format(primal[duplicate], HAND_KICKER_NONE, HAND_CHAIN);
 
-      for (j = 0; j < i; j++)
-        CardArray_PushBack(&hand.cards, CardArray_PopFront(array));
+      for (j = 0; j < n; j++)
+        CardHand_PushBack(&hand.cards, CardArray_PopFront(array));
 
-      HandList_PushFront(hl, &hand);
+      HandList_PushBack(hl, &hand);
     } else {
-      for (j = 0; j < i / duplicate; j++) {
+      /* not a chain */
+      for (j = 0; j < lengths[i]; j++) {
         Hand_Clear(&hand);
         hand.type =
             Hand_Format(primal[duplicate], HAND_KICKER_NONE, HAND_CHAINLESS);
 
         for (k = 0; k < duplicate; k++)
-          CardArray_PushBack(&hand.cards, CardArray_PopFront(array));
+          CardHand_PushBack(&hand.cards, CardArray_PopFront(array));
 
-        HandList_PushFront(hl, &hand);
+        HandList_PushBack(hl, &hand);
       }
     }
   }
 }
 
 /* extract nuke/bomb/2 from array, these cards will be removed from array */
-void _HandList_ExtractNukeBomb2(rk_list_t* hl, card_array_t* array,
-                                int* count) {
+void _HandList_ExtractNukeBomb2(hand_list_t* hl, card_array_t* array,
+                                uint8_t* count) {
   int i = 0;
   hand_t hand;
 
@@ -670,10 +852,12 @@ void _HandList_ExtractNukeBomb2(rk_list_t* hl, card_array_t* array,
   if (count[CARD_RANK_r] && count[CARD_RANK_R]) {
     Hand_Clear(&hand);
     hand.type = Hand_Format(HAND_PRIMAL_NUKE, HAND_KICKER_NONE, HAND_CHAINLESS);
-    CardArray_CopyRank(&hand.cards, array, CARD_RANK_R);
-    CardArray_CopyRank(&hand.cards, array, CARD_RANK_r);
+    CardHand_CopyRank(&hand.cards, array->cards, array->length,
+                      CARD_RANK_R);
+    CardHand_CopyRank(&hand.cards, array->cards, array->length,
+                      CARD_RANK_r);
 
-    HandList_PushFront(hl, &hand);
+    HandList_PushBack(hl, &hand);
 
     count[CARD_RANK_r] = 0;
     count[CARD_RANK_R] = 0;
@@ -688,9 +872,10 @@ void _HandList_ExtractNukeBomb2(rk_list_t* hl, card_array_t* array,
       Hand_Clear(&hand);
       hand.type =
           Hand_Format(HAND_PRIMAL_BOMB, HAND_KICKER_NONE, HAND_CHAINLESS);
-      CardArray_CopyRank(&hand.cards, array, (uint8_t)i);
+      CardHand_CopyRank(&hand.cards, array->cards, array->length,
+                      (uint8_t)i);
 
-      HandList_PushFront(hl, &hand);
+      HandList_PushBack(hl, &hand);
 
       count[i] = 0;
       CardArray_RemoveRank(array, (uint8_t)i);
@@ -700,11 +885,11 @@ void _HandList_ExtractNukeBomb2(rk_list_t* hl, card_array_t* array,
   /* joker */
   if ((count[CARD_RANK_r] != 0) || (count[CARD_RANK_R] != 0)) {
     Hand_Clear(&hand);
-    CardArray_CopyRank(&hand.cards, array,
-                       count[CARD_RANK_r] != 0 ? CARD_RANK_r : CARD_RANK_R);
+    CardHand_CopyRank(&hand.cards, array->cards, array->length,
+                      count[CARD_RANK_r] != 0 ? CARD_RANK_r : CARD_RANK_R);
     hand.type = Hand_Format(HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAINLESS);
 
-    HandList_PushFront(hl, &hand);
+    HandList_PushBack(hl, &hand);
     count[CARD_RANK_r] = 0;
     count[CARD_RANK_R] = 0;
     CardArray_RemoveRank(array, CARD_RANK_r);
@@ -714,7 +899,8 @@ void _HandList_ExtractNukeBomb2(rk_list_t* hl, card_array_t* array,
   /* 2 */
   if (count[CARD_RANK_2] != 0) {
     Hand_Clear(&hand);
-    CardArray_CopyRank(&hand.cards, array, CARD_RANK_2);
+    CardHand_CopyRank(&hand.cards, array->cards, array->length,
+                      CARD_RANK_2);
 
     switch (count[CARD_RANK_2]) {
     case 1:
@@ -737,14 +923,14 @@ void _HandList_ExtractNukeBomb2(rk_list_t* hl, card_array_t* array,
     }
     count[CARD_RANK_2] = 0;
     CardArray_RemoveRank(array, CARD_RANK_2);
-    HandList_PushFront(hl, &hand);
+    HandList_PushBack(hl, &hand);
   }
 }
 
-rk_list_t* HandList_StandardAnalyze(card_array_t* cards) {
+void HandList_StandardAnalyze(card_array_t* cards, hand_list_t* hl) {
   int i = 0;
-  int count[CARD_RANK_END];
-  rk_list_t* hl = NULL;
+  uint8_t* count = NULL;
+  rank_count_t ranks;
 
   card_array_t array;
   card_array_t arrsolo;
@@ -763,9 +949,10 @@ rk_list_t* HandList_StandardAnalyze(card_array_t* cards) {
   CardArray_Copy(&array, cards);
 
   CardArray_Sort(&array, NULL);
-  Hand_CountRank(&array, count, NULL);
+  RankCount_Copy(&ranks, &array.ranks);
+  count = ranks.n;
 
-  hl = rk_list_create();
+  HandList_Clear(hl);
 
   /* nuke, bomb and 2 */
   _HandList_ExtractNukeBomb2(hl, &array, count);
@@ -786,8 +973,6 @@ rk_list_t* HandList_StandardAnalyze(card_array_t* cards) {
   _HandList_ExtractConsecutive(hl, &arrtrio, 3);
   _HandList_ExtractConsecutive(hl, &arrpair, 2);
   _HandList_ExtractConsecutive(hl, &arrsolo, 1);
-
-  return hl;
 }
 
 /*
@@ -795,146 +980,174 @@ rk_list_t* HandList_StandardAnalyze(card_array_t* cards) {
  * hand evaluator
  * ************************************************************
  */
-int _HandList_CalculateConsecutive(card_array_t* array, int duplicate) {
-  int hands = 0;
+/* ranks a chain needs at least */
+#define HL_SOLO_CHAIN_RANKS HAND_SOLO_CHAIN_MIN_LENGTH
+#define HL_PAIR_CHAIN_RANKS (HAND_PAIR_CHAIN_MIN_LENGTH / 2)
+#define HL_TRIO_CHAIN_RANKS (HAND_TRIO_CHAIN_MIN_LENGTH / 3)
+
+/* hands of the runs in mask, a run of length ranks or more is one chain */
+int _HandList_RunHands(uint16_t mask, int length) {
   int i = 0;
-  int j = 0;
-  int k = 0;
-  int cardnum = 0;
-  uint8_t lastrank = 0;
-  int chainlen[] = {0, HAND_SOLO_CHAIN_MIN_LENGTH, HAND_PAIR_CHAIN_MIN_LENGTH,
-                    HAND_TRIO_CHAIN_MIN_LENGTH};
+  uint32_t chain = mask & RANK_MASK_CHAIN;
+  uint32_t start = RankMask_RunStarts(mask, length);
+  uint32_t cover = start;
 
-  if ((duplicate < 1) || (duplicate > 3))
-    return hands;
+  for (i = 1; i < length; i++)
+    cover |= start << i;
 
-  cardnum = array->length / duplicate;
-  lastrank = CARD_RANK(array->cards[0]);
-  i = duplicate;
+  return LMath_PopCount32(chain & ~cover) + RankMask_RunCount(cover);
+}
 
-  while (cardnum--) {
-    if ((lastrank - 1) != CARD_RANK(array->cards[i])) {
-      /* chain break */
-      if (i >= chainlen[duplicate]) {
-        /* chain */
-        for (j = 0; j < i; j++)
-          CardArray_PopFront(array);
+int HandList_StandardEvaluatorRanks(const rank_count_t* ranks) {
+  int hands = 0;
+  uint16_t any = RankCount_MaskGE(ranks, 1);
+  uint16_t bomb = RankCount_MaskEQ(ranks, 4);
 
-        hands++;
-      } else {
-        /* not a chain */
-        for (j = 0; j < i / duplicate; j++) {
-          for (k = 0; k < duplicate; k++)
-            CardArray_PopFront(array);
+  /* nuke or joker */
+  hands += (any >> CARD_RANK_r) != 0;
+  /* bomb */
+  hands += LMath_PopCount32(bomb);
+  /* 2 */
+  hands += ((any & ~bomb) >> CARD_RANK_2) & 1;
 
-          hands++;
-        }
-      }
+  /* chain */
+  hands += _HandList_RunHands(RankCount_MaskEQ(ranks, 3), HL_TRIO_CHAIN_RANKS);
+  hands += _HandList_RunHands(RankCount_MaskEQ(ranks, 2), HL_PAIR_CHAIN_RANKS);
+  hands += _HandList_RunHands(RankCount_MaskEQ(ranks, 1), HL_SOLO_CHAIN_RANKS);
 
-      if (array->length == 0)
-        break;
+  return hands;
+}
 
-      lastrank = CARD_RANK(array->cards[0]);
-      i = duplicate;
-    } else {
-      /* chain intact */
-      lastrank = CARD_RANK(array->cards[i]);
-      i += duplicate;
-    }
-  }
+int HandList_StandardEvaluator(card_array_t* array) {
+  return HandList_StandardEvaluatorRanks(&array->ranks);
+}
 
-  k = i - duplicate; /* step back */
+#ifdef LL_SSE2
 
-  if ((k != 0) && (k == array->length)) /* all chained up */
-  {
-    /* can chain up */
-    if (k >= chainlen[duplicate]) {
-      for (j = 0; j < i - duplicate; j++)
-        CardArray_PopFront(array);
+/* candidates evaluated together, one per 16 bit lane */
+#define HL_BATCH_LANES 8
 
-      hands++;
-    } else {
-      for (j = 0; j < k / duplicate; j++) {
-        for (i = 0; i < duplicate; i++)
-          CardArray_PopFront(array);
+/* population count of every 16 bit lane */
+__m128i _HandList_PopCount16(__m128i x) {
+  __m128i m1 = _mm_set1_epi16(0x5555);
+  __m128i m2 = _mm_set1_epi16(0x3333);
+  __m128i m4 = _mm_set1_epi16(0x0F0F);
 
-        hands++;
-      }
-    }
-  }
+  x = _mm_sub_epi16(x, _mm_and_si128(_mm_srli_epi16(x, 1), m1));
+  x = _mm_add_epi16(_mm_and_si128(x, m2),
+                    _mm_and_si128(_mm_srli_epi16(x, 2), m2));
+  x = _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 4)), m4);
 
-  return hands;
+  return _mm_and_si128(_mm_add_epi16(x, _mm_srli_epi16(x, 8)),
+                       _mm_set1_epi16(0x1F));
 }
 
-int HandList_StandardEvaluator(card_array_t* array) {
+/* _HandList_RunHands of every 16 bit lane */
+__m128i _HandList_RunHands16(__m128i mask, int length) {
   int i = 0;
-  int hands = 0;
-  int count[CARD_RANK_END];
-
-  card_array_t arrsolo;
-  card_array_t arrpair;
-  card_array_t arrtrio;
-  card_array_t* arrkicks[3];
-
-  arrkicks[0] = &arrsolo;
-  arrkicks[1] = &arrpair;
-  arrkicks[2] = &arrtrio;
-
-  CardArray_Clear(&arrsolo);
-  CardArray_Clear(&arrpair);
-  CardArray_Clear(&arrtrio);
+  __m128i chain = _mm_and_si128(mask, _mm_set1_epi16(RANK_MASK_CHAIN));
+  __m128i shift = chain;
+  __m128i start = chain;
+  __m128i cover;
+
+  for (i = 1; i < length; i++) {
+    shift = _mm_srli_epi16(shift, 1);
+    start = _mm_and_si128(start, shift);
+  }
 
-  CardArray_Sort(array, NULL);
-  Hand_CountRank(array, count, NULL);
+  cover = start;
 
-  /* nuke */
-  if (count[CARD_RANK_r] && count[CARD_RANK_R]) {
-    hands++;
-    count[CARD_RANK_r] = 0;
-    count[CARD_RANK_R] = 0;
+  for (i = 1; i < length; i++) {
+    start = _mm_slli_epi16(start, 1);
+    cover = _mm_or_si128(cover, start);
   }
 
-  /* bomb */
-  for (i = CARD_RANK_2; i >= CARD_RANK_3; i--) {
-    if (count[i] == 4) {
-      hands++;
-      count[i] = 0;
+  /* short runs count one hand per rank, long runs one hand each */
+  return _mm_add_epi16(
+      _HandList_PopCount16(_mm_andnot_si128(cover, chain)),
+      _HandList_PopCount16(
+          _mm_andnot_si128(_mm_slli_epi16(cover, 1), cover)));
+}
+
+void HandList_StandardEvaluatorBatch(const rank_count_t* base,
+                                     const rank_count_t* deltas, int count,
+                                     int* values) {
+  int i = 0;
+  int j = 0;
+  __m128i v;
+  __m128i any;
+  __m128i bomb;
+  __m128i hands;
+  __m128i vbase = _mm_loadu_si128((const __m128i*)base->n);
+  uint16_t masks[4][HL_BATCH_LANES];
+  int16_t lanes[HL_BATCH_LANES];
+
+  for (i = 0; i < count; i += HL_BATCH_LANES) {
+    /* rank masks of count 1 to 4 per candidate, unused lanes are empty */
+    for (j = 0; j < HL_BATCH_LANES; j++) {
+      v = _mm_setzero_si128();
+
+      if (i + j < count)
+        v = _mm_subs_epu8(vbase,
+                          _mm_loadu_si128((const __m128i*)deltas[i + j].n));
+
+      masks[0][j] = (uint16_t)_mm_movemask_epi8(
+          _mm_cmpeq_epi8(v, _mm_set1_epi8(1)));
+      masks[1][j] = (uint16_t)_mm_movemask_epi8(
+          _mm_cmpeq_epi8(v, _mm_set1_epi8(2)));
+      masks[2][j] = (uint16_t)_mm_movemask_epi8(
+          _mm_cmpeq_epi8(v, _mm_set1_epi8(3)));
+      masks[3][j] = (uint16_t)_mm_movemask_epi8(
+          _mm_cmpeq_epi8(v, _mm_set1_epi8(4)));
     }
-  }
 
-  /* joker */
-  if ((count[CARD_RANK_r] != 0) || (count[CARD_RANK_R] != 0)) {
-    hands++;
-    count[CARD_RANK_r] = 0;
-    count[CARD_RANK_R] = 0;
+    /* the same steps as HandList_StandardEvaluatorRanks, lane by lane */
+    bomb = _mm_loadu_si128((const __m128i*)masks[3]);
+    any = _mm_or_si128(
+        _mm_or_si128(_mm_loadu_si128((const __m128i*)masks[0]),
+                     _mm_loadu_si128((const __m128i*)masks[1])),
+        _mm_or_si128(_mm_loadu_si128((const __m128i*)masks[2]), bomb));
+
+    hands = _mm_min_epi16(_mm_srli_epi16(any, CARD_RANK_r), _mm_set1_epi16(1));
+    hands = _mm_add_epi16(hands, _HandList_PopCount16(bomb));
+    hands = _mm_add_epi16(
+        hands, _mm_and_si128(_mm_srli_epi16(_mm_andnot_si128(bomb, any),
+                                            CARD_RANK_2),
+                             _mm_set1_epi16(1)));
+
+    hands = _mm_add_epi16(
+        hands, _HandList_RunHands16(_mm_loadu_si128((const __m128i*)masks[2]),
+                                    HL_TRIO_CHAIN_RANKS));
+    hands = _mm_add_epi16(
+        hands, _HandList_RunHands16(_mm_loadu_si128((const __m128i*)masks[1]),
+                                    HL_PAIR_CHAIN_RANKS));
+    hands = _mm_add_epi16(
+        hands, _HandList_RunHands16(_mm_loadu_si128((const __m128i*)masks[0]),
+                                    HL_SOLO_CHAIN_RANKS));
+
+    _mm_storeu_si128((__m128i*)lanes, hands);
+
+    for (j = 0; j < HL_BATCH_LANES && i + j < count; j++)
+      values[i + j] = lanes[j];
   }
+}
 
-  /* 2 */
-  if (count[CARD_RANK_2] != 0)
-    hands++;
-
-  count[CARD_RANK_2] = 0;
+#else /* ifdef LL_SSE2 */
 
-  /* chains */
-  for (i = 0; i < array->length;) {
-    int c = count[CARD_RANK(array->cards[i])];
+void HandList_StandardEvaluatorBatch(const rank_count_t* base,
+                                     const rank_count_t* deltas, int count,
+                                     int* values) {
+  int i = 0;
+  rank_count_t ranks;
 
-    if (c != 0) {
-      CardArray_PushBackCards(arrkicks[c - 1], array, i, c);
-      i += c;
-    } else {
-      i++;
-    }
+  for (i = 0; i < count; i++) {
+    RankCount_Sub(&ranks, base, &deltas[i]);
+    values[i] = HandList_StandardEvaluatorRanks(&ranks);
   }
-
-  /* chain */
-  hands += _HandList_CalculateConsecutive(&arrtrio, 3);
-  hands += _HandList_CalculateConsecutive(&arrpair, 2);
-  hands += _HandList_CalculateConsecutive(&arrsolo, 1);
-
-  return hands;
 }
 
+#endif /* ifdef LL_SSE2 */
+
 /*
  * ************************************************************
  * advanced hand analyze
@@ -946,14 +1159,12 @@ void _HandList_SearchLongestConsecutive(hand_ctx_t* ctx, hand_t* hand,
   int i = 0;
   int j = 0;
   int k = 0;
-  int rankstart = 0;
-  uint8_t lastrank = 0;
+  int low = 0;
+  int length = 0;
   int primal[] = {0, HAND_PRIMAL_SOLO, HAND_PRIMAL_PAIR, HAND_PRIMAL_TRIO};
   int chainlen[] = {0, HAND_SOLO_CHAIN_MIN_LENGTH, HAND_PAIR_CHAIN_MIN_LENGTH,
                     HAND_TRIO_CHAIN_MIN_LENGTH};
-  card_array_t chain;
-  int* count = ctx->count;
-  card_array_t* cards = &ctx->rcards;
+  card_hand_t* cards = &ctx->rcards;
 
   if ((duplicate < 1) || (duplicate > 3))
     return;
@@ -963,67 +1174,37 @@ void _HandList_SearchLongestConsecutive(hand_ctx_t* ctx, hand_t* hand,
     return;
 
   /* setup */
-  CardArray_Clear(&chain);
-
   Hand_Clear(hand);
-  rankstart = 0;
 
-  /*
-   * i <= CARD_RANK_2
-   * but count[CARD_RANK_2] must be 0
-   * for 2/bomb/nuke has been removed before calling this function
-   */
-  for (i = CARD_RANK_3; i <= CARD_RANK_2; i++) {
-    /* find start of a possible chain */
-    if (rankstart == 0) {
-      if (count[i] >= duplicate)
-        rankstart = i;
-
-      continue;
-    }
-
-    /* chain break */
-    if (count[i] < duplicate) {
-      /* chain break, extract chain and set new possible start */
-      if ((((i - rankstart) * duplicate) >= chainlen[duplicate]) &&
-          ((i - rankstart) > chain.length)) {
-        /* valid chain, store rank in card_array_t */
-        CardArray_Clear(&chain);
+  /* 2/bomb/nuke have been removed before calling this function */
+  length = RankMask_LongestRun(RankCount_MaskGE(&ctx->count, duplicate), &low);
 
-        for (j = rankstart; j < i; j++)
-          CardArray_PushBack(&chain, (uint8_t)j);
-      }
-
-      rankstart = 0;
-    }
-  }
+  if (length * duplicate < chainlen[duplicate])
+    return;
 
-  /* convert rank array to card array */
-  if (chain.length > 0) {
-    for (i = chain.length - 1; i >= 0; i--) {
-      lastrank = chain.cards[i];
-      k = duplicate;
+  /* higher rank first, rcards gives lower suits first */
+  for (i = low + length - 1; i >= low; i--) {
+    k = duplicate;
 
-      for (j = 0; j < cards->length; j++) {
-        if (CARD_RANK(cards->cards[j]) == lastrank) {
-          CardArray_PushBack(&hand->cards, cards->cards[j]);
-          k--;
+    for (j = 0; j < cards->length; j++) {
+      if (CARD_RANK(cards->cards[j]) == i) {
+        CardHand_PushBack(&hand->cards, cards->cards[j]);
+        k--;
 
-          if (k == 0)
-            break;
-        }
+        if (k == 0)
+          break;
       }
     }
-
-    hand->type = Hand_Format(primal[duplicate], HAND_KICKER_NONE, HAND_CHAIN);
   }
+
+  hand->type = Hand_Format(primal[duplicate], HAND_KICKER_NONE, HAND_CHAIN);
 }
 
 void _HandList_SearchPrimal(hand_ctx_t* ctx, hand_t* hand, int primal) {
   int i = 0;
-  int* count = ctx->count;
+  uint8_t* count = ctx->count.n;
   int primals[] = {0, HAND_PRIMAL_SOLO, HAND_PRIMAL_PAIR, HAND_PRIMAL_TRIO};
-  card_array_t* rcards = &ctx->rcards;
+  card_hand_t* rcards = &ctx->rcards;
 
   if ((primal > 3) || (primal < 1))
     return;
@@ -1033,7 +1214,7 @@ void _HandList_SearchPrimal(hand_ctx_t* ctx, hand_t* hand, int primal) {
     if (count[CARD_RANK(rcards->cards[i])] >= primal) {
       /* found */
       Hand_Clear(hand);
-      CardArray_PushBackCards(&hand->cards, rcards, i, primal);
+      CardHand_PushBackCards(&hand->cards, rcards->cards + i, primal);
       hand->type =
           Hand_Format(primals[primal], HAND_KICKER_NONE, HAND_CHAINLESS);
       break;
@@ -1083,22 +1264,38 @@ int _HLAA_TraverseChains(hand_ctx_t* ctx, int* begin, hand_t* hand) {
     }
 
     /* if found == 0, should PANIC */
-  } else {
-    /* continue search via beat */
-    found = HandList_SearchBeat(&ctx->cards, hand, hand);
   }
 
   return found;
 }
 
+/* chains found from one context, more are dropped */
+#define HLAA_CHAIN_CAPACITY 192
+
+/* every chain has 5 cards or more */
+#define HLAA_DEPTH_MAX (CARD_HAND_PRESET_LENGTH / HAND_SOLO_CHAIN_MIN_LENGTH)
+
+/* threads exploring root chains at most */
+#define HLAA_WORKERS_MAX 16
+
+#define _HLAA_Append(hands, count, hand)                                       \
+  do {                                                                         \
+    if ((count) < HLAA_CHAIN_CAPACITY)                                         \
+      memcpy(&(hands)[(count)], (hand), sizeof(hand_t));                       \
+    (count)++;                                                                 \
+  } while (0)
+
 /*
- * extract all chains or primal hands in hand_ctx
+ * extract all chains in hand_ctx into hands,
+ * returns the number of chains found, at most HLAA_CHAIN_CAPACITY are stored
  */
-void _HLAA_ExtractAllChains(hand_ctx_t* ctx, rk_list_t* hands) {
+int _HLAA_ExtractAllChains(hand_ctx_t* ctx, hand_t* hands) {
   int found = 0;
+  int count = 0;
   int lastsearch = 0;
   hand_t workinghand;
   hand_t lasthand;
+  beat_iter_t iter;
 
   /* init search */
   Hand_Clear(&workinghand);
@@ -1107,19 +1304,20 @@ void _HLAA_ExtractAllChains(hand_ctx_t* ctx, rk_list_t* hands) {
   found = _HLAA_TraverseChains(ctx, &lastsearch, &lasthand);
 
   while (found != 0) {
-    HandList_PushFront(hands, &lasthand);
+    _HLAA_Append(hands, count, &lasthand);
 
-    Hand_Copy(&workinghand, &lasthand);
+    /* same type hands above, bombs are extracted already */
+    BeatIter_Init(&iter, ctx, &lasthand, NULL, BEAT_ITER_NO_BOMB);
 
-    while ((found = _HLAA_TraverseChains(ctx, &lastsearch, &workinghand)) != 0)
-      HandList_PushFront(hands, &workinghand);
+    while ((found = BeatIter_Next(&iter, &workinghand)) != 0)
+      _HLAA_Append(hands, count, &workinghand);
 
     /* can't find any more hands, try to reduce chain length */
     if (lasthand.type != 0) {
       if (lasthand.type ==
           Hand_Format(HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN)) {
         if (lasthand.cards.length > HAND_SOLO_CHAIN_MIN_LENGTH) {
-          CardArray_DropFront(&lasthand.cards, 1);
+          CardHand_DropFront(&lasthand.cards, 1);
           found = 1;
         } else {
           lasthand.type = 0;
@@ -1127,7 +1325,7 @@ void _HLAA_ExtractAllChains(hand_ctx_t* ctx, rk_list_t* hands) {
       } else if (lasthand.type ==
                  Hand_Format(HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN)) {
         if (lasthand.cards.length > HAND_PAIR_CHAIN_MIN_LENGTH) {
-          CardArray_DropFront(&lasthand.cards, 2);
+          CardHand_DropFront(&lasthand.cards, 2);
           found = 1;
         } else {
           lasthand.type = 0;
@@ -1135,7 +1333,7 @@ void _HLAA_ExtractAllChains(hand_ctx_t* ctx, rk_list_t* hands) {
       } else if (lasthand.type ==
                  Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAIN)) {
         if (lasthand.cards.length > HAND_TRIO_CHAIN_MIN_LENGTH) {
-          CardArray_DropFront(&lasthand.cards, 3);
+          CardHand_DropFront(&lasthand.cards, 3);
           found = 1;
         } else {
           lasthand.type = 0;
@@ -1150,179 +1348,426 @@ void _HLAA_ExtractAllChains(hand_ctx_t* ctx, rk_list_t* hands) {
       }
     }
   }
+
+  return count < HLAA_CHAIN_CAPACITY ? count : HLAA_CHAIN_CAPACITY;
 }
 
-/* advanced search tree payload */
-typedef struct _hltree_payload_s {
-  /* hand context */
-  hand_ctx_t ctx;
-  /* hand */
-  hand_t hand;
-  /* evaluation weight */
+/*
+ * lower bound of any leaf weight below ctx, not counting depth,
+ * every hand covers one run at most and a chain joins no runs
+ */
+#define _HLAA_LowerBound(ctx)                                                  \
+  (RankMask_RunCount(RankCount_MaskGE(&(ctx)->count, 1)) +                     \
+   ((ctx)->count.n[CARD_RANK_2] != 0) +                                        \
+   (((ctx)->count.n[CARD_RANK_r] | (ctx)->count.n[CARD_RANK_R]) != 0))
+
+/* heavier than any leaf, every hand has one card at least */
+#define HLAA_WEIGHT_MAX (CARD_HAND_PRESET_LENGTH + 1)
+
+/* advanced search frame, chains of one context */
+typedef struct _hlaa_frame_s {
+  /* chains found */
+  int count;
+  /* next chain to play, counting down */
+  int next;
+  hand_t chains[HLAA_CHAIN_CAPACITY];
+
+} _hlaa_frame_t;
+
+/* leaf found, chains played to reach it */
+typedef struct _hlaa_path_s {
   int weight;
+  int length;
+  /* sorted chain keys, the same chains in any order are the same leaf */
+  hand_key_t keys[HLAA_DEPTH_MAX];
+  hand_t chains[HLAA_DEPTH_MAX];
+
+} _hlaa_path_t;
+
+/* advanced search state, one per thread */
+typedef struct _hlaa_search_s {
+  /* context of frames[depth] */
+  hand_ctx_t ctx;
+  /* lightest leaves kept, lighter first and then in search order */
+  _hlaa_path_t* paths;
+  int capacity;
+  int count;
+  _hlaa_frame_t frames[HLAA_DEPTH_MAX + 1];
+
+} _hlaa_search_t;
+
+/* workers sharing the root chains of one advanced search */
+typedef struct _hlaa_pool_s {
+  /* root context and chains, read only while searching */
+  _hlaa_search_t* root;
+  /* next root chain to explore, counting down like the serial search */
+  atomic_int next;
+  /* lightest leaf weight found by any worker */
+  atomic_int weight;
+  _hlaa_path_t results[HLAA_CHAIN_CAPACITY];
+
+} _hlaa_pool_t;
+
+/* leaves as heavy as this are cut, nothing kept could be replaced */
+#define _HLAA_Bound(search)                                                    \
+  ((search)->count < (search)->capacity                                        \
+       ? HLAA_WEIGHT_MAX                                                       \
+       : (search)->paths[(search)->capacity - 1].weight)
+
+/*
+ * keep the leaf at depth if it is among the lightest, returns 0 if it is
+ * too heavy or the same chains were kept already
+ */
+int _HLAA_Keep(_hlaa_search_t* search, int depth, int weight) {
+  int i = 0;
+  int j = 0;
+  int pos = 0;
+  hand_key_t key = 0;
+  _hlaa_frame_t* frame = NULL;
+  _hlaa_path_t* kept = NULL;
+  _hlaa_path_t path;
+
+  /* after every leaf as light */
+  for (pos = search->count; pos > 0; pos--) {
+    if (search->paths[pos - 1].weight <= weight)
+      break;
+  }
+
+  if (pos >= search->capacity)
+    return 0;
+
+  path.weight = weight;
+  path.length = depth;
+
+  for (i = 0; i < depth; i++) {
+    frame = &search->frames[i];
+    memcpy(&path.chains[i], &frame->chains[frame->next], sizeof(hand_t));
+    key = Hand_Key(&path.chains[i]);
+
+    for (j = i; j > 0 && path.keys[j - 1] > key; j--)
+      path.keys[j] = path.keys[j - 1];
+
+    path.keys[j] = key;
+  }
+
+  /* same chains leave the same cards, so only equal weights can repeat */
+  for (i = pos - 1; i >= 0; i--) {
+    kept = &search->paths[i];
 
-} _hltree_payload_t;
+    if (kept->weight != weight)
+      break;
 
-rk_tree_t* _HLAA_TreeAddHand(rk_tree_t* tree, rk_list_node_t* handnode) {
-  _hltree_payload_t* oldpayload = NULL;
-  _hltree_payload_t* newpayload = NULL;
+    if (kept->length == depth &&
+        memcmp(kept->keys, path.keys, depth * sizeof(hand_key_t)) == 0)
+      return 0;
+  }
 
-  oldpayload = (_hltree_payload_t*)tree->payload;
-  newpayload = (_hltree_payload_t*)malloc(sizeof(_hltree_payload_t));
+  if (search->count < search->capacity)
+    search->count++;
 
-  /* make diff here */
-  memcpy(&newpayload->ctx, &oldpayload->ctx, sizeof(hand_ctx_t));
-  Hand_Copy(&newpayload->hand, HandList_GetHand(handnode));
-  CardArray_Subtract(&newpayload->ctx.cards,
-                     &HandList_GetHand(handnode)->cards);
-  CardArray_Copy(&newpayload->ctx.rcards, &newpayload->ctx.cards);
-  CardArray_Reverse(&newpayload->ctx.rcards);
-  Hand_CountRank(&newpayload->ctx.cards, newpayload->ctx.count, NULL);
-  newpayload->weight = oldpayload->weight + 1;
+  memmove(&search->paths[pos + 1], &search->paths[pos],
+          (search->count - 1 - pos) * sizeof(_hlaa_path_t));
+  memcpy(&search->paths[pos], &path, sizeof(_hlaa_path_t));
 
-  /* expand the tree */
-  return rk_tree_add_child(tree, newpayload);
+  return 1;
 }
 
 /*
- * search hand via least hands
+ * depth first branch and bound below search->frames[0], weight of a leaf is
+ * chains played plus the standard evaluation of its leftover. chains are
+ * tried last first, the same leaf order the full search tree used, so the
+ * first strictly lighter leaf wins and subtrees that can't beat the leaves
+ * kept are cut. with a shared weight, subtrees strictly heavier than it are
+ * cut as well, ties are kept so the serial winner is still found
  */
-rk_list_t* HandList_AdvancedAnalyze(card_array_t* array) {
-  rk_list_t* handlist = NULL;
-  rk_list_t* chains = NULL;
-  rk_list_t* others = NULL;
-  rk_list_node_t* hlnode = NULL;
-  rk_list_t* st = NULL;
-  rk_tree_t* grandtree = NULL;
-  rk_tree_t* workingtree = NULL;
-  rk_tree_t* tnode = NULL;
-  rk_tree_t* shortest = NULL;
-  _hltree_payload_t* pload = NULL;
+void _HLAA_Search(_hlaa_search_t* search, atomic_int* shared) {
+  _hlaa_frame_t* frame = NULL;
+  hand_ctx_t* ctx = &search->ctx;
+  int depth = 0;
+  int bound = 0;
+  int weight = 0;
+  card_array_t leftover;
+
+  while (depth >= 0) {
+    frame = &search->frames[depth];
+    bound = _HLAA_Bound(search);
+
+    if (shared != NULL) {
+      weight = atomic_load_explicit(shared, memory_order_relaxed) + 1;
+      bound = weight < bound ? weight : bound;
+    }
 
-  hand_ctx_t ctx;
+    if (frame->next == 0 || depth + _HLAA_LowerBound(ctx) >= bound) {
+      /* exhausted or bounded, back to parent context */
+      if (--depth >= 0) {
+        frame = &search->frames[depth];
+        HandCtx_Add(ctx, &frame->chains[frame->next].cards);
+      }
 
-  handlist = rk_list_create();
+      continue;
+    }
 
-  /* setup search context */
-  HandCtx_Clear(&ctx);
+    frame->next--;
+    HandCtx_Remove(ctx, &frame->chains[frame->next].cards);
+    depth++;
+    frame = &search->frames[depth];
+    frame->count = 0;
 
-  /* build beat search context */
-  Hand_CountRank(array, ctx.count, NULL);
-  CardArray_Copy(&ctx.cards, array);
+    if (depth < HLAA_DEPTH_MAX)
+      frame->count = _HLAA_ExtractAllChains(ctx, frame->chains);
 
-  /* extract bombs and 2 */
-  _HandList_ExtractNukeBomb2(handlist, &ctx.cards, ctx.count);
+    frame->next = frame->count;
 
-  /* finish building beat_search_context */
-  CardArray_Copy(&ctx.rcards, &ctx.cards);
-  CardArray_Reverse(&ctx.rcards);
+    if (frame->count != 0)
+      continue;
 
-  /* magic goes here */
+    /* leaf, calculate other hands weight */
+    if (depth + _HLAA_LowerBound(ctx) < bound) {
+      CardHand_ToArray(&ctx->cards, &leftover);
+      weight = depth + EvalCache_StandardEvaluator(&leftover);
 
-  /* root */
-  pload = (_hltree_payload_t*)malloc(sizeof(_hltree_payload_t));
-  memcpy(&pload->ctx, &ctx, sizeof(hand_ctx_t));
-  pload->weight = 0;
-  grandtree = rk_tree_create(pload);
+      if (_HLAA_Keep(search, depth, weight) && shared != NULL) {
+        bound = atomic_load_explicit(shared, memory_order_relaxed);
+        weight = _HLAA_Bound(search);
 
-  /* first expansion */
-  chains = rk_list_create();
-  _HLAA_ExtractAllChains(&ctx, chains);
+        while (weight < bound &&
+               !atomic_compare_exchange_weak_explicit(
+                   shared, &bound, weight, memory_order_relaxed,
+                   memory_order_relaxed))
+          ;
+      }
+    }
+  }
+}
 
-  /* no chains, fall back to standard analyze */
-  if (rk_list_empty(chains)) {
-    rk_list_clear_destroy(handlist);
-    rk_list_clear_destroy(chains);
-    rk_tree_clear_destroy(grandtree);
-    return HandList_StandardAnalyze(array);
+/* explore root chains one by one until none is left */
+void* _HLAA_Worker(void* arg) {
+  _hlaa_pool_t* pool = (_hlaa_pool_t*)arg;
+  _hlaa_search_t search;
+  _hlaa_path_t best;
+  int next = 0;
+
+  while ((next = atomic_fetch_sub(&pool->next, 1) - 1) >= 0) {
+    /* a root of the single chain, its subtree is the serial one */
+    memcpy(&search.ctx, &pool->root->ctx, sizeof(hand_ctx_t));
+    memcpy(&search.frames[0].chains[0], &pool->root->frames[0].chains[next],
+           sizeof(hand_t));
+    search.frames[0].count = 1;
+    search.frames[0].next = 1;
+    search.paths = &best;
+    search.capacity = 1;
+    search.count = 0;
+    best.weight = HLAA_WEIGHT_MAX;
+
+    _HLAA_Search(&search, &pool->weight);
+
+    memcpy(&pool->results[next], &best, sizeof(_hlaa_path_t));
   }
 
-  /* got chains, make first expand */
-  hlnode = chains->first;
-  st = rk_list_create();
+  return NULL;
+}
 
-  while (hlnode != NULL) {
-    tnode = _HLAA_TreeAddHand(grandtree, hlnode);
-    rk_list_push(st, tnode);
+/* search root chains on workers, keep the first lightest in serial order */
+void _HLAA_SearchParallel(_hlaa_search_t* root, int workers) {
+  _hlaa_pool_t pool;
+  pthread_t threads[HLAA_WORKERS_MAX];
+  int spawned = 0;
+  int i = 0;
 
-    hlnode = hlnode->next;
-  }
+  pool.root = root;
+  atomic_init(&pool.next, root->frames[0].count);
+  atomic_init(&pool.weight, HLAA_WEIGHT_MAX);
 
-  rk_list_clear_destroy(chains);
+  if (workers > HLAA_WORKERS_MAX)
+    workers = HLAA_WORKERS_MAX;
 
-  /* loop start */
-  while (!rk_list_empty(st)) {
-    /* pop stack */
-    workingtree = rk_list_pop(st);
-    chains = rk_list_create();
-    pload = (_hltree_payload_t*)workingtree->payload;
+  if (workers > root->frames[0].count)
+    workers = root->frames[0].count;
 
-    /* expansion */
-    _HLAA_ExtractAllChains(&pload->ctx, chains);
+  /* calling thread is a worker too, spawn failures leave it more work */
+  for (i = 1; i < workers; i++)
+    if (pthread_create(&threads[spawned], NULL, _HLAA_Worker, &pool) == 0)
+      spawned++;
 
-    if (!rk_list_empty(chains)) {
-      /* push new nodes */
-      hlnode = chains->first;
+  _HLAA_Worker(&pool);
 
-      while (hlnode != NULL) {
-        tnode = _HLAA_TreeAddHand(workingtree, hlnode);
-        rk_list_push(st, tnode);
+  for (i = 0; i < spawned; i++)
+    pthread_join(threads[i], NULL);
 
-        hlnode = hlnode->next;
-      }
+  for (i = root->frames[0].count - 1; i >= 0; i--) {
+    if (pool.results[i].weight < _HLAA_Bound(root)) {
+      memcpy(&root->paths[0], &pool.results[i], sizeof(_hlaa_path_t));
+      root->count = 1;
     }
+  }
+}
+
+/*
+ * set up the root context and chains of array, bombs, nuke and 2 go to
+ * special, returns the number of root chains, 0 as well if more than
+ * CARD_HAND_PRESET_LENGTH cards are left
+ */
+int _HLAA_Setup(_hlaa_search_t* search, card_array_t* array,
+                hand_list_t* special) {
+  hand_ctx_t* ctx = &search->ctx;
+  _hlaa_frame_t* root = &search->frames[0];
+  card_array_t cards;
+
+  HandList_Clear(special);
+
+  /* setup search context */
+  HandCtx_Clear(ctx);
+
+  /* build beat search context */
+  RankCount_Copy(&ctx->count, &array->ranks);
+  CardArray_Copy(&cards, array);
+  CardArray_Sort(&cards, NULL);
+
+  /* extract bombs and 2 */
+  _HandList_ExtractNukeBomb2(special, &cards, ctx->count.n);
+
+  /* finish building beat_search_context, too many cards left to search */
+  if (!CardHand_FromArray(&ctx->cards, &cards)) {
+    root->count = 0;
+    return 0;
+  }
+
+  CardHand_Copy(&ctx->rcards, &ctx->cards);
+  CardHand_Reverse(&ctx->rcards);
+
+  /* magic goes here */
+  root->count = _HLAA_ExtractAllChains(ctx, root->chains);
+  root->next = root->count;
+
+  return root->count;
+}
+
+/* hand list of a leaf, ctx is the root context and is restored */
+void _HLAA_Materialize(hand_ctx_t* ctx, _hlaa_path_t* path,
+                       hand_list_t* special, hand_list_t* hl) {
+  int i = 0;
+  hand_t hand;
+  rank_hand_t rhand;
+  card_array_t leftover;
+
+  /* replay the path */
+  for (i = 0; i < path->length; i++)
+    HandCtx_Remove(ctx, &path->chains[i].cards);
+
+  /* extract leaf's other hands */
+  CardHand_ToArray(&ctx->cards, &leftover);
+  HandList_StandardAnalyze(&leftover, hl);
+
+  /* materialize hands with cards from their parent context, last first */
+  for (i = path->length - 1; i >= 0; i--) {
+    HandCtx_Add(ctx, &path->chains[i].cards);
+    RankHand_FromHand(&rhand, &path->chains[i]);
+    RankHand_ToHand(&rhand, &hand, ctx->cards.cards, ctx->cards.length);
+    HandList_PushBack(hl, &hand);
+  }
+
+  HandList_Concat(hl, special);
+}
+
+/*
+ * search hand via least hands, root chains are explored by worker threads
+ * when there are more than one, the result doesn't depend on workers
+ */
+void HandList_AdvancedAnalyzeParallel(card_array_t* array, hand_list_t* hl,
+                                      int workers) {
+  hand_list_t special;
+  _hlaa_search_t search;
+  _hlaa_path_t best;
 
-    rk_list_clear_destroy(chains);
+  /* no chains, fall back to standard analyze */
+  if (_HLAA_Setup(&search, array, &special) == 0) {
+    HandList_StandardAnalyze(array, hl);
+    return;
   }
 
-  /* tree construction complete */
-  rk_tree_dump_leaves(grandtree, st);
+  search.paths = &best;
+  search.capacity = 1;
+  search.count = 0;
+
+  if (workers > 1)
+    _HLAA_SearchParallel(&search, workers);
+  else
+    _HLAA_Search(&search, NULL);
+
+  /* search restored ctx */
+  _HLAA_Materialize(&search.ctx, &best, &special, hl);
+}
+
+/* search hand via least hands */
+void HandList_AdvancedAnalyze(card_array_t* array, hand_list_t* hl) {
+  HandList_AdvancedAnalyzeParallel(array, hl, 1);
+}
+
+/* fill the cost breakdown of a decomposition from its hand list */
+void _HandDecomp_Score(hand_decomp_t* decomp) {
+  int i = 0;
+  hand_t* hand = NULL;
+
+  decomp->hands = HandList_Length(&decomp->hl);
+  decomp->solos = 0;
+  decomp->controls = 0;
 
-  /* find shortest path */
-  while (!rk_list_empty(st)) {
-    /* pop stack */
-    workingtree = rk_list_pop(st);
-    pload = (_hltree_payload_t*)workingtree->payload;
+  for (i = 0; i < decomp->hands; i++) {
+    hand = HandList_Get(&decomp->hl, i);
 
-    /* calculate other hands weight */
-    pload->weight += HandList_StandardEvaluator(&pload->ctx.cards);
+    if (hand->type ==
+        Hand_Format(HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAINLESS))
+      decomp->solos++;
 
-    if ((shortest == NULL) ||
-        (pload->weight < ((_hltree_payload_t*)shortest->payload)->weight))
-      shortest = workingtree;
+    if (Hand_GetPrimal(hand->type) >= HAND_PRIMAL_BOMB ||
+        CARD_RANK(hand->cards.cards[0]) >= CARD_RANK_2)
+      decomp->controls++;
   }
+}
 
-  rk_list_clear_destroy(st);
+int HandList_AdvancedAnalyzeTopK(card_array_t* array, hand_decomp_t* decomps,
+                                 int k) {
+  int i = 0;
+  hand_list_t special;
+  _hlaa_search_t search;
+  _hlaa_path_t paths[HAND_DECOMP_MAX];
 
-  /* extract shortest node's other hands */
-  others = HandList_StandardAnalyze(
-      &((_hltree_payload_t*)(shortest->payload))->ctx.cards);
+  if (k <= 0)
+    return 0;
 
-  while (shortest != NULL &&
-         ((_hltree_payload_t*)shortest->payload)->weight != 0) {
-    HandList_PushFront(others,
-                       &((_hltree_payload_t*)(shortest->payload))->hand);
-    shortest = shortest->parent;
+  /* no chains, standard analyze is the only decomposition */
+  if (_HLAA_Setup(&search, array, &special) == 0) {
+    HandList_StandardAnalyze(array, &decomps[0].hl);
+    decomps[0].weight = HandList_StandardEvaluatorRanks(&search.ctx.count);
+    decomps[0].chains = 0;
+    _HandDecomp_Score(&decomps[0]);
+    return 1;
   }
 
-  rk_list_concat(others, handlist);
-  handlist->first = NULL;
-  handlist->last = NULL;
-  rk_list_destroy(handlist);
+  search.paths = paths;
+  search.capacity = k < HAND_DECOMP_MAX ? k : HAND_DECOMP_MAX;
+  search.count = 0;
 
-  rk_tree_clear_destroy(grandtree);
+  _HLAA_Search(&search, NULL);
 
-  return others;
+  /* search restored ctx after every leaf */
+  for (i = 0; i < search.count; i++) {
+    _HLAA_Materialize(&search.ctx, &paths[i], &special, &decomps[i].hl);
+    decomps[i].weight = paths[i].weight;
+    decomps[i].chains = paths[i].length;
+    _HandDecomp_Score(&decomps[i]);
+  }
+
+  return search.count;
 }
 
 /* TODO */
 int HandList_AdvancedEvaluator(card_array_t* array) {
-  int value = 0;
-  rk_list_t* hl = HandList_AdvancedAnalyze(array);
-  value = rk_list_count(hl);
-  rk_list_clear_destroy(hl);
+  hand_list_t hl;
+
+  HandList_AdvancedAnalyze(array, &hl);
 
-  return value;
+  return HandList_Length(&hl);
 }
 
 /*
@@ -1333,115 +1778,218 @@ int HandList_AdvancedEvaluator(card_array_t* array) {
 
 #define BEAT_VALUE_FACTOR 10
 
-/* nodes for beat list sort */
-typedef struct beat_node_s {
-  hand_t* hand;
-  int value;
+#define BeatIter_IsBomb(h) (Hand_GetPrimal((h)->type) >= HAND_PRIMAL_BOMB)
+
+/* a before b, lower value first, search order on tie */
+#define BeatNode_Before(a, b)                                                  \
+  (((a)->value < (b)->value) ||                                                \
+   (((a)->value == (b)->value) && ((a)->seq < (b)->seq)))
+
+void BeatIter_Init(beat_iter_t* iter, hand_ctx_t* ctx, hand_t* tobeat,
+                   HandList_EvaluateFunc func, int flags) {
+  iter->ctx = ctx;
+  iter->func = func;
+  iter->flags = flags;
+  iter->state = BEAT_ITER_SEARCH;
+  iter->count = 0;
+  iter->pending = 0;
+  Hand_Copy(&iter->cursor, tobeat);
+}
+
+/* search the next beat after cursor, in search order */
+int _BeatIter_Search(beat_iter_t* iter, hand_t* beat) {
+  int canbeat = 0;
+
+  if (iter->flags & BEAT_ITER_NO_BOMB)
+    canbeat = _HandList_SearchBeatType(iter->ctx, &iter->cursor, beat);
+  else
+    canbeat = _HandList_SearchBeatCtx(iter->ctx, &iter->cursor, beat);
+
+  if (canbeat)
+    Hand_Copy(&iter->cursor, beat);
 
-} beat_node_t;
+  return canbeat;
+}
+
+void _BeatIter_SiftDown(beat_node_t* nodes, int count, int i) {
+  int child = 0;
+  beat_node_t node;
+
+  memcpy(&node, &nodes[i], sizeof(beat_node_t));
+
+  while ((child = 2 * i + 1) < count) {
+    if ((child + 1 < count) &&
+        BeatNode_Before(&nodes[child + 1], &nodes[child]))
+      child++;
+
+    if (!BeatNode_Before(&nodes[child], &node))
+      break;
 
-/* sort function */
-int _BeatNode_ValueSort(const void* a, const void* b) {
-  return ((*(beat_node_t**)a)->value - (*(beat_node_t**)b)->value);
+    memcpy(&nodes[i], &nodes[child], sizeof(beat_node_t));
+    i = child;
+  }
+
+  memcpy(&nodes[i], &node, sizeof(beat_node_t));
 }
 
-int HandList_BestBeat(card_array_t* array, hand_t* tobeat, hand_t* beat,
-                      HandList_EvaluateFunc func) {
+/* delta evaluator giving the same values as func, NULL if none does */
+HandList_DeltaEvaluateFunc
+_BeatIter_DeltaEvaluator(HandList_EvaluateFunc func) {
+  if (func == HandList_StandardEvaluator ||
+      func == EvalCache_StandardEvaluator)
+    return EvalCache_StandardEvaluatorDelta;
+
+  if (func == HandList_AdvancedEvaluator ||
+      func == EvalCache_AdvancedEvaluator)
+    return EvalCache_AdvancedEvaluatorDelta;
+
+  return NULL;
+}
+
+/*
+ * collect hands up to the first bomb and score them,
+ * the search resumes from that bomb once the heap runs out
+ */
+void _BeatIter_Fill(beat_iter_t* iter) {
   int i = 0;
-  int nodei = 0;
-  int bombi = 0;
-  int canbeat = 0;
-  rk_list_t* hl = NULL;
-  rk_list_node_t* node = NULL;
+  beat_node_t* node = NULL;
+  card_array_t array;
   card_array_t temp;
-  beat_node_t* hnodes[BEAT_NODE_CAPACITY];
-  hand_t* hbombs[BEAT_NODE_CAPACITY];
-  HandList_EvaluateFunc evalFunc;
+  rank_count_t deltas[BEAT_NODE_CAPACITY];
+  int values[BEAT_NODE_CAPACITY];
+  HandList_DeltaEvaluateFunc evaluate = NULL;
 
-  evalFunc = (func == NULL) ? HandList_StandardEvaluator : func;
+  while ((iter->count < BEAT_NODE_CAPACITY) &&
+         _BeatIter_Search(iter, &iter->nodes[iter->count].hand)) {
+    node = &iter->nodes[iter->count];
 
-  memset(hnodes, 0, sizeof(beat_node_t*) * BEAT_NODE_CAPACITY);
-  memset(hbombs, 0, sizeof(hand_t*) * BEAT_NODE_CAPACITY);
+    if (BeatIter_IsBomb(&node->hand)) {
+      iter->pending = 1;
+      break;
+    }
+
+    node->value = 0;
+    node->seq = iter->count++;
+  }
 
-  /* search beat list */
-  hl = HandList_SearchBeatList(array, tobeat);
+  /* a single candidate needs no evaluation */
+  if (iter->count > 1) {
+    evaluate = _BeatIter_DeltaEvaluator(iter->func);
 
-  /* separate bomb/nuke and normal hands */
-  node = hl->first;
+    if (evaluate != NULL) {
+      /* counts are enough, candidates are deltas of the context */
+      for (i = 0; i < iter->count; i++)
+        RankCount_Build(&deltas[i], iter->nodes[i].hand.cards.cards,
+                        iter->nodes[i].hand.cards.length);
 
-  while (node != NULL) {
-    if ((HandList_GetHand(node)->type ==
-         Hand_Format(HAND_PRIMAL_BOMB, HAND_KICKER_NONE, HAND_CHAINLESS)) ||
-        (HandList_GetHand(node)->type ==
-         Hand_Format(HAND_PRIMAL_NUKE, HAND_KICKER_NONE, HAND_CHAINLESS))) {
-      hbombs[bombi++] = node->payload;
+      if (evaluate == EvalCache_StandardEvaluatorDelta) {
+        HandList_StandardEvaluatorBatch(&iter->ctx->count, deltas,
+                                        iter->count, values);
+      } else {
+        for (i = 0; i < iter->count; i++)
+          values[i] = evaluate(&iter->ctx->count, &deltas[i]);
+      }
     } else {
-      hnodes[nodei] = (beat_node_t*)malloc(sizeof(beat_node_t));
-      hnodes[nodei]->hand = node->payload;
-      nodei++;
+      CardHand_ToArray(&iter->ctx->cards, &array);
+
+      for (i = 0; i < iter->count; i++) {
+        CardArray_Copy(&temp, &array);
+        CardArray_SubtractHand(&temp, &iter->nodes[i].hand.cards);
+        values[i] = iter->func(&temp);
+      }
     }
 
-    node = node->next;
-  }
+    for (i = 0; i < iter->count; i++) {
+      node = &iter->nodes[i];
+      node->value = values[i] * BEAT_VALUE_FACTOR +
+                    CARD_RANK(node->hand.cards.cards[0]);
+    }
 
-  /* calculate value */
-  if (nodei > 1) {
-    for (i = 0; i < nodei; i++) {
-      hand_t* leftover;
-      CardArray_Copy(&temp, array);
+    for (i = iter->count / 2 - 1; i >= 0; i--)
+      _BeatIter_SiftDown(iter->nodes, iter->count, i);
+  }
+}
 
-      /* evaluate the value of cards left after hand was played */
-      leftover = hnodes[i]->hand;
-      CardArray_Subtract(&temp, &leftover->cards);
+int BeatIter_Next(beat_iter_t* iter, hand_t* beat) {
+  /* search order */
+  if (iter->func == NULL) {
+    if (iter->state == BEAT_ITER_DONE)
+      return 0;
 
-      hnodes[i]->value = evalFunc(&temp) * BEAT_VALUE_FACTOR +
-                         CARD_RANK(leftover->cards.cards[0]);
-    }
+    if (!_BeatIter_Search(iter, beat))
+      iter->state = BEAT_ITER_DONE;
 
-    /* sort primal hands */
-    qsort(hnodes, nodei, sizeof(beat_node_t*), _BeatNode_ValueSort);
+    return iter->state != BEAT_ITER_DONE;
   }
 
-  /* re-build hand list */
-  rk_list_destroy(hl);
-  hl = rk_list_create();
+  if (iter->state == BEAT_ITER_SEARCH) {
+    _BeatIter_Fill(iter);
+    iter->state = BEAT_ITER_HEAP;
+  }
 
-  for (i = bombi; i >= 0; i--) {
-    if (hbombs[i]) {
-      rk_list_push(hl, hbombs[i]);
+  /* cheapest hand first */
+  if (iter->state == BEAT_ITER_HEAP) {
+    if (iter->count > 0) {
+      Hand_Copy(beat, &iter->nodes[0].hand);
+      iter->count--;
+      memcpy(&iter->nodes[0], &iter->nodes[iter->count], sizeof(beat_node_t));
+      _BeatIter_SiftDown(iter->nodes, iter->count, 0);
+      return 1;
     }
+
+    iter->state = BEAT_ITER_BOMB;
   }
 
-  for (i = nodei; i >= 0; i--) {
-    if (hnodes[i]) {
-      rk_list_push(hl, hnodes[i]->hand);
+  /* then bombs and nuke, lowest first */
+  if (iter->state == BEAT_ITER_BOMB) {
+    if (iter->pending) {
+      iter->pending = 0;
+      Hand_Copy(beat, &iter->cursor);
+      return 1;
     }
-  }
 
-  /* select beat */
-  if (!rk_list_empty(hl)) {
-    Hand_Copy(beat, HandList_GetHand(hl->first));
-    canbeat = 1;
+    /* hands beyond node capacity are skipped */
+    while (_BeatIter_Search(iter, beat)) {
+      if (BeatIter_IsBomb(beat))
+        return 1;
+    }
+
+    iter->state = BEAT_ITER_DONE;
   }
 
-  /* clean up */
-  for (i = 0; i < nodei; i++)
-    free(hnodes[i]);
+  return 0;
+}
 
-  rk_list_clear_destroy(hl);
+int HandList_BestBeat(card_array_t* array, hand_t* tobeat, hand_t* beat,
+                      HandList_EvaluateFunc func) {
+  hand_ctx_t ctx;
 
-  return canbeat;
+  if (!HandCtx_Setup(&ctx, array))
+    return 0;
+
+  return HandList_BestBeatCtx(&ctx, tobeat, beat, func);
+}
+
+int HandList_BestBeatCtx(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat,
+                         HandList_EvaluateFunc func) {
+  beat_iter_t iter;
+
+  /* only the best one is needed */
+  BeatIter_Init(&iter, ctx, tobeat,
+                (func == NULL) ? HandList_StandardEvaluator : func, 0);
+
+  return BeatIter_Next(&iter, beat);
 }
 
-void HandList_Print(rk_list_t* hl) {
-  rk_list_node_t* node = NULL;
+void HandList_Print(hand_list_t* hl) {
+  int i = 0;
 
-  if (hl == NULL || rk_list_empty(hl) || HandList_GetHand(hl->first)->type == 0)
+  if (hl == NULL || HandList_IsEmpty(hl) || hl->hands[0].type == 0)
     return;
 
   DBGLog("-----hand_list_t begin---------\n");
-  for (node = hl->first; node != NULL; node = node->next) {
-    Hand_Print(HandList_GetHand(node));
+  for (i = 0; i < hl->length; i++) {
+    Hand_Print(&hl->hands[i]);
   }
   DBGLog("-----hand_list_t ended---------\n");
 }
@@ -26,7 +26,6 @@ SOFTWARE.
 #define LANDLORD_HANDLIST_H
 
 #include "hand.h"
-#include "ruiko_algorithm.h"
 
 /* ************************************************************
  * hand list
@@ -34,25 +33,169 @@ SOFTWARE.
 
 typedef int (*HandList_EvaluateFunc)(card_array_t*);
 
+/* evaluates rank counts minus a delta, cards never leave the counts */
+typedef int (*HandList_DeltaEvaluateFunc)(const rank_count_t*,
+                                          const rank_count_t*);
+
+/* enough for every beat of a hand */
+#define HAND_LIST_CAPACITY 255
+
+/*
+ * contiguous hand list with fixed capacity, hands are stored by value
+ * so building, copying and dropping a list never touches the heap
+ */
+typedef struct _hand_list_s {
+  int length;
+  hand_t hands[HAND_LIST_CAPACITY];
+
+} hand_list_t;
+
+#define HandList_Clear(hl) ((hl)->length = 0)
+#define HandList_Length(hl) ((hl)->length)
+#define HandList_IsEmpty(hl) ((hl)->length == 0)
+#define HandList_IsFull(hl) ((hl)->length >= HAND_LIST_CAPACITY)
+#define HandList_Get(hl, i) (&(hl)->hands[(i)])
+
+/*
+ * append a hand, return 0 if list is full
+ */
+int HandList_PushBack(hand_list_t* hl, hand_t* hand);
+
+/*
+ * append hands of src to dst, hands that don't fit are dropped
+ */
+void HandList_Concat(hand_list_t* dst, hand_list_t* src);
+
 /*
- * push a hand into the front of hand list
+ * remove the hand at where, later hands move up and keep their order
  */
-void HandList_PushFront(rk_list_t* hl, hand_t* hand);
+void HandList_RemoveAt(hand_list_t* hl, int where);
 
 /*
- * remove a hand from hand list
+ * remove the hand at where in O(1), the last hand takes its place
  */
-void HandList_Remove(rk_list_t* hl, hand_t* hand);
+void HandList_SwapRemove(hand_list_t* hl, int where);
+
+/*
+ * remove a hand of hand list by address, order is kept
+ */
+void HandList_Remove(hand_list_t* hl, hand_t* hand);
 
 /*
  * search a specific hand type from hand list
  */
-hand_t* HandList_Find(rk_list_t* hl, int handtype);
+hand_t* HandList_Find(hand_list_t* hl, int handtype);
+
+/* ************************************************************
+ * hand index
+ * ************************************************************/
+
+/* one bucket per hand type */
+#define HAND_INDEX_TYPES 256
+#define HAND_INDEX_NONE 0xFF
+
+/* lead rank of a hand, primal cards go first, highest first */
+#define HandIndex_Lead(h) CARD_RANK((h)->cards.cards[0])
+
+/*
+ * hands of a hand list bucketed by type, a bucket is a linked list of
+ * list positions ordered by lead rank, hands with the same lead keep
+ * list order with the earlier one above, so the highest of a type is
+ * what HandList_Find returns on a list from the standard analyzer
+ *
+ * hands must be removed through HandIndex_Remove to keep it in sync
+ */
+typedef struct _hand_index_s {
+  uint8_t count[HAND_INDEX_TYPES];
+  uint8_t lowest[HAND_INDEX_TYPES];
+  uint8_t highest[HAND_INDEX_TYPES];
+  uint8_t lower[HAND_LIST_CAPACITY];  /* next lower hand of the type */
+  uint8_t higher[HAND_LIST_CAPACITY]; /* next higher hand of the type */
+
+} hand_index_t;
+
+#define HandIndex_Count(index, type) ((index)->count[(uint8_t)(type)])
+
+/*
+ * index every hand of hand list
+ */
+void HandIndex_Build(hand_index_t* index, hand_list_t* hl);
+
+/*
+ * hand of type with the lowest lead rank, NULL if none
+ */
+hand_t* HandIndex_Lowest(hand_index_t* index, hand_list_t* hl, int type);
+
+/*
+ * hand of type with the highest lead rank, NULL if none
+ */
+hand_t* HandIndex_Highest(hand_index_t* index, hand_list_t* hl, int type);
+
+/*
+ * remove a hand from hand list and index, list order is kept
+ */
+void HandIndex_Remove(hand_index_t* index, hand_list_t* hl, hand_t* hand);
+
+/* ************************************************************
+ * hand decomposition
+ * ************************************************************/
+
+/* decompositions HandList_AdvancedAnalyzeTopK keeps at most */
+#define HAND_DECOMP_MAX 16
+
+/*
+ * one way to split cards into hands, with its cost breakdown
+ */
+typedef struct _hand_decomp_s {
+  int weight;   /* search weight, chains and standard evaluation of the rest */
+  int hands;    /* hands in list */
+  int chains;   /* chains played by the search */
+  int solos;    /* single card hands */
+  int controls; /* bombs, nuke and hands led by 2 or joker */
+  hand_list_t hl;
+
+} hand_decomp_t;
+
+/* ************************************************************
+ * search context
+ * ************************************************************/
+
+/*
+ * beat search context, a player keeps one alongside its cards
+ * and updates it with HandCtx_Remove/HandCtx_Add instead of
+ * setting it up again for every search
+ *
+ * it holds CARD_HAND_PRESET_LENGTH (20) cards at most, so beat searches
+ * on a longer card array find nothing, and the advanced analyzers fall
+ * back to standard analyze when more than 20 cards are left for chains
+ */
+typedef struct hand_ctx_s {
+  /* rank count */
+  rank_count_t count;
+  /* sorted cards, higher rank first */
+  card_hand_t cards;
+  /* reverse sorted cards */
+  card_hand_t rcards;
+
+} hand_ctx_t;
+
+#define HandCtx_Clear(ctx) memset((ctx), 0, sizeof(hand_ctx_t))
 
 /*
- * get payload as hand_t
+ * setup search context from card array, return 0 and leave ctx empty
+ * if array has more than CARD_HAND_PRESET_LENGTH cards
  */
-#define HandList_GetHand(h) ((hand_t*)((h)->payload))
+int HandCtx_Setup(hand_ctx_t* ctx, card_array_t* array);
+
+/*
+ * remove cards from context, cards not held are ignored
+ */
+void HandCtx_Remove(hand_ctx_t* ctx, card_hand_t* hand);
+
+/*
+ * add cards to context, cards must not be held by context
+ */
+void HandCtx_Add(hand_ctx_t* ctx, card_hand_t* hand);
 
 /* ************************************************************
  * utils
@@ -63,40 +206,146 @@ hand_t* HandList_Find(rk_list_t* hl, int handtype);
  */
 int HandList_SearchBeat(card_array_t* cards, hand_t* tobeat, hand_t* beat);
 
+/*
+ * check if cards can beat tobeat at all, bomb and nuke included,
+ * answered from rank counts without building a hand
+ */
+int HandList_CanBeat(card_array_t* cards, hand_t* tobeat);
+
+/*
+ * search a beat in search context, same as HandList_SearchBeat
+ */
+int HandList_SearchBeatCtx(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat);
+
 /*
  * search all the beats
  */
-rk_list_t* HandList_SearchBeatList(card_array_t* cards, hand_t* tobeat);
+void HandList_SearchBeatList(card_array_t* cards, hand_t* tobeat,
+                             hand_list_t* beats);
+
+/*
+ * search all the beats in search context
+ */
+void HandList_SearchBeatListCtx(hand_ctx_t* ctx, hand_t* tobeat,
+                                hand_list_t* beats);
 
 /*
  * standard analyze a card array into hand list
  */
-rk_list_t* HandList_StandardAnalyze(card_array_t* array);
+void HandList_StandardAnalyze(card_array_t* array, hand_list_t* hl);
 
 /*
  * count how many primal hands in array
  */
 int HandList_StandardEvaluator(card_array_t* array);
 
+/*
+ * HandList_StandardEvaluator from rank counts alone
+ */
+int HandList_StandardEvaluatorRanks(const rank_count_t* ranks);
+
+/*
+ * standard evaluate base minus each of count deltas into values,
+ * candidates share one setup and are evaluated in SIMD lanes
+ */
+void HandList_StandardEvaluatorBatch(const rank_count_t* base,
+                                     const rank_count_t* deltas, int count,
+                                     int* values);
+
 /*
  * advanced hand analyze
  */
-rk_list_t* HandList_AdvancedAnalyze(card_array_t* array);
+void HandList_AdvancedAnalyze(card_array_t* array, hand_list_t* hl);
+
+/*
+ * advanced hand analyze with top level chains explored on worker threads,
+ * same hand list as the serial analyze, 1 or less workers is serial
+ */
+void HandList_AdvancedAnalyzeParallel(card_array_t* array, hand_list_t* hl,
+                                      int workers);
+
+/*
+ * decompose array into the k lightest hand lists of the advanced search,
+ * lightest first, in one search, returns the number found.
+ * at most HAND_DECOMP_MAX are kept and the same chains are never repeated
+ */
+int HandList_AdvancedAnalyzeTopK(card_array_t* array, hand_decomp_t* decomps,
+                                 int k);
 
 /*
  * advanced hand evaluator
  */
 int HandList_AdvancedEvaluator(card_array_t* array);
 
+/* ************************************************************
+ * beat iterator
+ * ************************************************************/
+
+#define BEAT_NODE_CAPACITY 255
+
+/* iterator flags, do not fall back to bomb/nuke */
+#define BEAT_ITER_NO_BOMB 1
+
+/* iterator states */
+#define BEAT_ITER_SEARCH 0
+#define BEAT_ITER_HEAP 1
+#define BEAT_ITER_BOMB 2
+#define BEAT_ITER_DONE 3
+
+typedef struct beat_node_s {
+  hand_t hand;
+  int value; /* evaluator cost, lower is better */
+  int seq;   /* search order */
+
+} beat_node_t;
+
+/*
+ * yields beats one at a time without allocating
+ *
+ * without an evaluator beats come in search order, lowest first, then bombs
+ * with an evaluator hands up to the first bomb are scored and come cheapest
+ * first from a heap, bombs and nuke follow in search order and are only
+ * searched once the heap runs out
+ */
+typedef struct beat_iter_s {
+  hand_ctx_t* ctx;
+  HandList_EvaluateFunc func;
+  int flags;
+  int state;
+  hand_t cursor; /* search resumes after cursor */
+  int count;     /* hands in heap */
+  int pending;   /* cursor is a bomb not yielded yet */
+  beat_node_t nodes[BEAT_NODE_CAPACITY];
+
+} beat_iter_t;
+
+/*
+ * start iterating beats of tobeat in ctx, func may be NULL
+ * ctx must stay unchanged while iterating
+ */
+void BeatIter_Init(beat_iter_t* iter, hand_ctx_t* ctx, hand_t* tobeat,
+                   HandList_EvaluateFunc func, int flags);
+
+/*
+ * get the next beat, return 0 when there is none
+ */
+int BeatIter_Next(beat_iter_t* iter, hand_t* beat);
+
 /*
  * search best beat from given cards
  */
 int HandList_BestBeat(card_array_t* array, hand_t* tobeat, hand_t* beat,
                       HandList_EvaluateFunc func);
 
+/*
+ * search best beat from search context
+ */
+int HandList_BestBeatCtx(hand_ctx_t* ctx, hand_t* tobeat, hand_t* beat,
+                         HandList_EvaluateFunc func);
+
 /*
  * print hand_list_t
  */
-void HandList_Print(rk_list_t* hl);
+void HandList_Print(hand_list_t* hl);
 
 #endif /* LANDLORD_HANDLIST_H */
@@ -29,13 +29,17 @@ SOFTWARE.
 #include "card.h"
 #include "common.h"
 #include "deck.h"
+#include "evalcache.h"
+#include "evaltable.h"
 #include "game.h"
 #include "hand.h"
 #include "handlist.h"
 #include "lmath.h"
 #include "memtracker.h"
+#include "move.h"
 #include "player.h"
 #include "ruiko_algorithm.h"
+#include "solver.h"
 #include "standard_ai.h"
 
 #endif /* LANDLORD_LANDLORD_H */
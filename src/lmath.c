@@ -190,3 +190,30 @@ void LMath_Shuffle(uint8_t* a, size_t n, mt19937_t* mt) {
     a[i] = tmp;
   }
 }
+
+/* ************************************************************
+ * bit operations
+ * ************************************************************/
+
+int LMath_BitCount64(uint64_t x) {
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+  return (int)((x * 0x0101010101010101ULL) >> 56);
+}
+
+int LMath_TrailingZero64(uint64_t x) {
+  return LMath_BitCount64((x & (0 - x)) - 1);
+}
+
+int LMath_LeadingZero64(uint64_t x) {
+  int n = 0;
+
+  while ((x & 0x8000000000000000ULL) == 0) {
+    x <<= 1;
+    n++;
+  }
+
+  return n;
+}
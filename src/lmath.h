@@ -58,6 +58,30 @@ void LMath_Shuffle(uint8_t* a, size_t n, mt19937_t* mt);
 
 int LMath_NextComb(int comb[], int k, int n);
 
+/* ************************************************************
+ * bit operations
+ * ************************************************************/
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LMath_PopCount32(x) __builtin_popcount((uint32_t)(x))
+#define LMath_PopCount64(x) __builtin_popcountll((uint64_t)(x))
+#define LMath_Ctz64(x) __builtin_ctzll((uint64_t)(x))
+#define LMath_Clz64(x) __builtin_clzll((uint64_t)(x))
+#else
+#define LMath_PopCount32(x) LMath_BitCount64((uint64_t)(uint32_t)(x))
+#define LMath_PopCount64(x) LMath_BitCount64((uint64_t)(x))
+#define LMath_Ctz64(x) LMath_TrailingZero64((uint64_t)(x))
+#define LMath_Clz64(x) LMath_LeadingZero64((uint64_t)(x))
+#endif
+
+/*
+ * portable fallbacks of the bit macros above
+ * x must not be 0 for trailing/leading zero count
+ */
+int LMath_BitCount64(uint64_t x);
+int LMath_TrailingZero64(uint64_t x);
+int LMath_LeadingZero64(uint64_t x);
+
 #ifdef __cplusplus
 }
 #endif
@@ -50,24 +50,20 @@ void test_advanced_hand_analyzer() {
    */
   const char* str = "♣T ♦9 ♠8 ♥8 ♠7 ♣7 ♦6 ♣6 ♠5 ♣5 ♣4";
   card_array_t cards;
-  rk_list_t* hl;
+  hand_list_t hl;
 
   CardArray_InitFromString(&cards, str);
 
   CardArray_Print(&cards);
 
-  hl = HandList_AdvancedAnalyze(&cards);
+  HandList_AdvancedAnalyze(&cards, &hl);
 
-  HandList_Print(hl);
-
-  rk_list_clear_destroy(hl);
+  HandList_Print(&hl);
 
   printf("------\n");
 
-  hl = NULL;
-  hl = HandList_StandardAnalyze(&cards);
-  HandList_Print(hl);
-  rk_list_clear_destroy(hl);
+  HandList_StandardAnalyze(&cards, &hl);
+  HandList_Print(&hl);
 }
 
 #ifdef TRY_MULTITHREAD
@@ -181,6 +177,7 @@ void test_game() {
 
   printf("peasants : %d\n", peasantwon);
   printf("landlord : %d\n", landlordwon);
+  EvalCache_Print();
 
   Game_Clear(&game);
 
@@ -240,8 +237,8 @@ int test_adv() {
   int diff = 0;
   deck_t deck;
   card_array_t cards;
-  rk_list_t* hladv = NULL;
-  rk_list_t* hlstd = NULL;
+  hand_list_t hladv;
+  hand_list_t hlstd;
   mt19937_t mt;
 
   Random_Init(&mt, (uint32_t)get_current_time_with_ns());
@@ -249,32 +246,28 @@ int test_adv() {
   Deck_Shuffle(&deck, &mt);
   Deck_Deal(&deck, &cards, 11);
 
-  hladv = HandList_AdvancedAnalyze(&cards);
-  hlstd = HandList_StandardAnalyze(&cards);
+  HandList_AdvancedAnalyze(&cards, &hladv);
+  HandList_StandardAnalyze(&cards, &hlstd);
 
-  diff = hlstd->count - hladv->count;
+  diff = HandList_Length(&hlstd) - HandList_Length(&hladv);
   if (diff >= 2) {
     CardArray_Sort(&cards, NULL);
     CardArray_Print(&cards);
     printf("***************************\n");
-    HandList_Print(hlstd);
+    HandList_Print(&hlstd);
     printf("***************************\n");
-    HandList_Print(hladv);
+    HandList_Print(&hladv);
   }
 
-  rk_list_clear_destroy(hladv);
-  rk_list_clear_destroy(hlstd);
-
   return diff;
 }
 
 void do_the_test() {
   const char* str_card = "♣T ♦9 ♠8 ♥8 ♠7 ♣7 ♦6 ♣6 ♠5 ♣5 ♣4";
   card_array_t cards;
-  rk_list_t* hl = NULL;
+  hand_list_t hl;
   CardArray_InitFromString(&cards, str_card);
-  hl = HandList_AdvancedAnalyze(&cards);
-  rk_list_clear_destroy(hl);
+  HandList_AdvancedAnalyze(&cards, &hl);
 }
 
 int main(int argc, const char* argv[]) {
@@ -282,8 +275,15 @@ int main(int argc, const char* argv[]) {
   char* pool = (char*)malloc(512 * 1024);
   memset(pool, 0, 512 * 1024);
   free(pool);
+
+  /* precomputed evaluator tables are optional */
+  EvalTable_Open(EVAL_TABLE_STANDARD_PATH);
+  EvalTable_Open(EVAL_TABLE_ADVANCED_PATH);
+
   test_game();
 
+  EvalTable_Close();
+
   history_purge();
 
   /* do_the_test(); */
@@ -0,0 +1,611 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "move.h"
+
+/* move class, a hand type with a chain length */
+typedef struct _move_class_s {
+  uint8_t type;
+  uint8_t chain; /* primal ranks */
+  uint8_t leads; /* lead positions */
+  uint8_t m;     /* ranks a kicker can take */
+  uint8_t k;     /* kicker ranks */
+  uint16_t base; /* first move id */
+
+} _move_class_t;
+
+#define MOVE_CLASS_COUNT 44
+
+#define Move_Class(p, k, c)                                                    \
+  Hand_Format(HAND_PRIMAL_##p, HAND_KICKER_##k, HAND_##c)
+
+/* ids are assigned in table order, bomb and nuke must stay last */
+const _move_class_t _move_classes[MOVE_CLASS_COUNT] = {
+    {Move_Class(SOLO, NONE, CHAINLESS), 1, 15, 0, 0, 0},
+    {Move_Class(PAIR, NONE, CHAINLESS), 1, 13, 0, 0, 15},
+    {Move_Class(TRIO, NONE, CHAINLESS), 1, 13, 0, 0, 28},
+    {Move_Class(TRIO, SOLO, CHAINLESS), 1, 13, 14, 1, 41},
+    {Move_Class(TRIO, PAIR, CHAINLESS), 1, 13, 12, 1, 223},
+    {Move_Class(FOUR, DUAL_SOLO, CHAINLESS), 1, 13, 14, 2, 379},
+    {Move_Class(FOUR, DUAL_PAIR, CHAINLESS), 1, 13, 12, 2, 1562},
+    {Move_Class(SOLO, NONE, CHAIN), 5, 8, 0, 0, 2420},
+    {Move_Class(SOLO, NONE, CHAIN), 6, 7, 0, 0, 2428},
+    {Move_Class(SOLO, NONE, CHAIN), 7, 6, 0, 0, 2435},
+    {Move_Class(SOLO, NONE, CHAIN), 8, 5, 0, 0, 2441},
+    {Move_Class(SOLO, NONE, CHAIN), 9, 4, 0, 0, 2446},
+    {Move_Class(SOLO, NONE, CHAIN), 10, 3, 0, 0, 2450},
+    {Move_Class(SOLO, NONE, CHAIN), 11, 2, 0, 0, 2453},
+    {Move_Class(SOLO, NONE, CHAIN), 12, 1, 0, 0, 2455},
+    {Move_Class(PAIR, NONE, CHAIN), 3, 10, 0, 0, 2456},
+    {Move_Class(PAIR, NONE, CHAIN), 4, 9, 0, 0, 2466},
+    {Move_Class(PAIR, NONE, CHAIN), 5, 8, 0, 0, 2475},
+    {Move_Class(PAIR, NONE, CHAIN), 6, 7, 0, 0, 2483},
+    {Move_Class(PAIR, NONE, CHAIN), 7, 6, 0, 0, 2490},
+    {Move_Class(PAIR, NONE, CHAIN), 8, 5, 0, 0, 2496},
+    {Move_Class(PAIR, NONE, CHAIN), 9, 4, 0, 0, 2501},
+    {Move_Class(PAIR, NONE, CHAIN), 10, 3, 0, 0, 2505},
+    {Move_Class(TRIO, NONE, CHAIN), 2, 11, 0, 0, 2508},
+    {Move_Class(TRIO, NONE, CHAIN), 3, 10, 0, 0, 2519},
+    {Move_Class(TRIO, NONE, CHAIN), 4, 9, 0, 0, 2529},
+    {Move_Class(TRIO, NONE, CHAIN), 5, 8, 0, 0, 2538},
+    {Move_Class(TRIO, NONE, CHAIN), 6, 7, 0, 0, 2546},
+    {Move_Class(TRIO, SOLO, CHAIN), 2, 11, 13, 2, 2553},
+    {Move_Class(TRIO, SOLO, CHAIN), 3, 10, 12, 3, 3411},
+    {Move_Class(TRIO, SOLO, CHAIN), 4, 9, 11, 4, 5611},
+    {Move_Class(TRIO, SOLO, CHAIN), 5, 8, 10, 5, 8581},
+    {Move_Class(TRIO, PAIR, CHAIN), 2, 11, 11, 2, 10597},
+    {Move_Class(TRIO, PAIR, CHAIN), 3, 10, 10, 3, 11202},
+    {Move_Class(TRIO, PAIR, CHAIN), 4, 9, 9, 4, 12402},
+    {Move_Class(FOUR, NONE, CHAIN), 2, 11, 0, 0, 13536},
+    {Move_Class(FOUR, NONE, CHAIN), 3, 10, 0, 0, 13547},
+    {Move_Class(FOUR, NONE, CHAIN), 4, 9, 0, 0, 13557},
+    {Move_Class(FOUR, NONE, CHAIN), 5, 8, 0, 0, 13566},
+    {Move_Class(FOUR, DUAL_SOLO, CHAIN), 2, 11, 13, 4, 13574},
+    {Move_Class(FOUR, DUAL_SOLO, CHAIN), 3, 10, 12, 6, 21439},
+    {Move_Class(FOUR, DUAL_PAIR, CHAIN), 2, 11, 11, 4, 30679},
+    {Move_Class(BOMB, NONE, CHAINLESS), 1, 13, 0, 0, MOVE_BOMB_BASE},
+    {Move_Class(NUKE, NONE, CHAINLESS), 1, 1, 0, 0, MOVE_NUKE}};
+
+/* binomial coefficients C(n, k), n < 16, k < 8 */
+const uint16_t _move_binomial[16][8] = {
+    {1, 0, 0, 0, 0, 0, 0, 0},
+    {1, 1, 0, 0, 0, 0, 0, 0},
+    {1, 2, 1, 0, 0, 0, 0, 0},
+    {1, 3, 3, 1, 0, 0, 0, 0},
+    {1, 4, 6, 4, 1, 0, 0, 0},
+    {1, 5, 10, 10, 5, 1, 0, 0},
+    {1, 6, 15, 20, 15, 6, 1, 0},
+    {1, 7, 21, 35, 35, 21, 7, 1},
+    {1, 8, 28, 56, 70, 56, 28, 8},
+    {1, 9, 36, 84, 126, 126, 84, 36},
+    {1, 10, 45, 120, 210, 252, 210, 120},
+    {1, 11, 55, 165, 330, 462, 462, 330},
+    {1, 12, 66, 220, 495, 792, 924, 792},
+    {1, 13, 78, 286, 715, 1287, 1716, 1716},
+    {1, 14, 91, 364, 1001, 2002, 3003, 3432},
+    {1, 15, 105, 455, 1365, 3003, 5005, 6435}};
+
+#define MOVE_BINOMIAL(n, k) (_move_binomial[(n)][(k)])
+
+/* highest rank a kicker of this type can take */
+#define Move_KickerMaxRank(type)                                               \
+  (((Hand_GetKicker(type) == HAND_KICKER_PAIR) ||                              \
+    (Hand_GetKicker(type) == HAND_KICKER_DUAL_PAIR))                           \
+       ? CARD_RANK_2                                                           \
+       : CARD_RANK_R)
+
+int _Move_FindClass(int type, int chain) {
+  int i = 0;
+
+  for (i = 0; i < MOVE_CLASS_COUNT; i++) {
+    if ((_move_classes[i].type == type) && (_move_classes[i].chain == chain))
+      return i;
+  }
+
+  return -1;
+}
+
+/* class of a valid id */
+int _Move_ClassOf(move_id_t id) {
+  int lo = 0;
+  int hi = MOVE_CLASS_COUNT - 1;
+  int mid = 0;
+
+  /* last class with base <= id */
+  while (lo < hi) {
+    mid = (lo + hi + 1) / 2;
+
+    if (_move_classes[mid].base <= id)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+
+  return lo;
+}
+
+/* primal rank mask of a rank hand */
+#define Move_RunMask(rh)                                                       \
+  ((uint16_t)(((1 << (rh)->chain) - 1) << ((rh)->rank - (rh)->chain + 1)))
+
+move_id_t Move_FromRankHand(const rank_hand_t* rh) {
+  int c = 0;
+  int n = 0;
+  int rank = 0;
+  int lead = 0;
+  int colex = 0;
+  uint16_t run = 0;
+  uint16_t kicker = 0;
+  uint16_t eligible = 0;
+  const _move_class_t* mc = NULL;
+
+  c = _Move_FindClass(rh->type, rh->chain);
+
+  if (c < 0)
+    return MOVE_NONE;
+
+  mc = &_move_classes[c];
+
+  /* lead index */
+  if (rh->type == HAND_PRIMAL_NUKE)
+    return (rh->rank == CARD_RANK_R && rh->kicker == 0) ? MOVE_NUKE : MOVE_NONE;
+  else if (rh->type == HAND_PRIMAL_SOLO)
+    lead = rh->rank - 1;
+  else
+    lead = rh->rank - rh->chain;
+
+  if ((lead < 0) || (lead >= mc->leads))
+    return MOVE_NONE;
+
+  /* kickers */
+  run = Move_RunMask(rh);
+  eligible = (uint16_t)(((1 << (Move_KickerMaxRank(rh->type) + 1)) - 2) & ~run);
+
+  if ((rh->kicker & ~eligible) || (LMath_PopCount32(rh->kicker) != mc->k))
+    return MOVE_NONE;
+
+  for (kicker = rh->kicker; kicker != 0; kicker &= kicker - 1) {
+    rank = LMath_Ctz64(kicker);
+    n++;
+    colex += MOVE_BINOMIAL(rank - 1 - LMath_PopCount32(run & ((1 << rank) - 1)),
+                           n);
+  }
+
+  return (move_id_t)(mc->base + lead * MOVE_BINOMIAL(mc->m, mc->k) + colex);
+}
+
+move_id_t Move_FromHand(hand_t* hand) {
+  rank_hand_t rh;
+
+  RankHand_FromHand(&rh, hand);
+
+  return Move_FromRankHand(&rh);
+}
+
+int Move_ToRankHand(move_id_t id, rank_hand_t* rh) {
+  int i = 0;
+  int j = 0;
+  int c = 0;
+  int lead = 0;
+  int offset = 0;
+  int index[8];
+  uint16_t run = 0;
+  const _move_class_t* mc = NULL;
+
+  RankHand_Clear(rh);
+
+  if (id >= MOVE_COUNT)
+    return 0;
+
+  mc = &_move_classes[_Move_ClassOf(id)];
+  offset = id - mc->base;
+  lead = offset / MOVE_BINOMIAL(mc->m, mc->k);
+  offset = offset % MOVE_BINOMIAL(mc->m, mc->k);
+
+  rh->type = mc->type;
+  rh->chain = mc->chain;
+
+  if (mc->type == HAND_PRIMAL_NUKE)
+    rh->rank = CARD_RANK_R;
+  else if (mc->type == HAND_PRIMAL_SOLO)
+    rh->rank = (uint8_t)(lead + 1);
+  else
+    rh->rank = (uint8_t)(lead + mc->chain);
+
+  /* colex unrank, highest kicker index first */
+  for (j = mc->k, c = mc->m - 1; j > 0; j--) {
+    while (MOVE_BINOMIAL(c, j) > offset)
+      c--;
+
+    offset -= MOVE_BINOMIAL(c, j);
+    index[j - 1] = c;
+  }
+
+  /* kicker index to rank, skipping primal ranks */
+  run = Move_RunMask(rh);
+
+  for (i = CARD_RANK_3, j = 0, c = 0; j < mc->k; i++) {
+    if (run & (1 << i))
+      continue;
+
+    if (index[j] == c)
+      rh->kicker |= (uint16_t)(1 << i), j++;
+
+    c++;
+  }
+
+  return 1;
+}
+
+int Move_ToHand(move_id_t id, hand_t* hand, const uint8_t* cards, int length) {
+  rank_hand_t rh;
+
+  if (!Move_ToRankHand(id, &rh))
+    return 0;
+
+  return RankHand_ToHand(&rh, hand, cards, length);
+}
+
+int Move_BeatRanges(move_id_t id, move_range_t* ranges) {
+  int n = 0;
+  int size = 0;
+  const _move_class_t* mc = NULL;
+
+  if (id >= MOVE_NUKE)
+    return 0;
+
+  if (id >= MOVE_BOMB_BASE) {
+    ranges[0].begin = (move_id_t)(id + 1);
+    ranges[0].end = MOVE_COUNT;
+    return 1;
+  }
+
+  /* higher leads in the same class */
+  mc = &_move_classes[_Move_ClassOf(id)];
+  size = MOVE_BINOMIAL(mc->m, mc->k);
+
+  if ((id - mc->base) / size + 1 < mc->leads) {
+    ranges[n].begin =
+        (move_id_t)(mc->base + ((id - mc->base) / size + 1) * size);
+    ranges[n].end = (move_id_t)(mc->base + mc->leads * size);
+    n++;
+  }
+
+  /* bombs and nuke */
+  ranges[n].begin = MOVE_BOMB_BASE;
+  ranges[n].end = MOVE_COUNT;
+  n++;
+
+  return n;
+}
+
+int Move_Beats(move_id_t a, move_id_t b) {
+  int i = 0;
+  int n = 0;
+  move_range_t ranges[MOVE_BEAT_RANGES];
+
+  if ((a >= MOVE_COUNT) || (b >= MOVE_COUNT))
+    return 0;
+
+  n = Move_BeatRanges(b, ranges);
+
+  for (i = 0; i < n; i++) {
+    if ((a >= ranges[i].begin) && (a < ranges[i].end))
+      return 1;
+  }
+
+  return 0;
+}
+
+/*
+ * ************************************************************
+ * move set
+ * ************************************************************
+ */
+
+/* bits of word i inside [begin, end) */
+uint64_t _MoveSet_RangeMask(int i, int begin, int end) {
+  uint64_t mask = ~(uint64_t)0;
+
+  if (i == (begin >> 6))
+    mask &= ~(uint64_t)0 << (begin & 63);
+
+  if ((i == (end >> 6)) && (end & 63))
+    mask &= ((uint64_t)1 << (end & 63)) - 1;
+
+  return mask;
+}
+
+void MoveSet_AddRange(move_set_t* set, move_id_t begin, move_id_t end) {
+  int i = 0;
+
+  if (begin >= end)
+    return;
+
+  for (i = begin >> 6; i <= (end - 1) >> 6; i++)
+    set->w[i] |= _MoveSet_RangeMask(i, begin, end);
+}
+
+void MoveSet_AddBeats(move_set_t* set, move_id_t id) {
+  int i = 0;
+  int n = 0;
+  move_range_t ranges[MOVE_BEAT_RANGES];
+
+  n = Move_BeatRanges(id, ranges);
+
+  for (i = 0; i < n; i++)
+    MoveSet_AddRange(set, ranges[i].begin, ranges[i].end);
+}
+
+void MoveSet_And(move_set_t* dst, const move_set_t* a, const move_set_t* b) {
+  int i = 0;
+
+  for (i = 0; i < MOVE_SET_WORDS; i++)
+    dst->w[i] = a->w[i] & b->w[i];
+}
+
+void MoveSet_AndBeats(move_set_t* dst, const move_set_t* candidates,
+                      move_id_t id) {
+  int i = 0;
+  int j = 0;
+  int n = 0;
+  move_range_t ranges[MOVE_BEAT_RANGES];
+
+  MoveSet_Clear(dst);
+  n = Move_BeatRanges(id, ranges);
+
+  for (j = 0; j < n; j++) {
+    for (i = ranges[j].begin >> 6; i <= (ranges[j].end - 1) >> 6; i++)
+      dst->w[i] |= candidates->w[i] &
+                   _MoveSet_RangeMask(i, ranges[j].begin, ranges[j].end);
+  }
+}
+
+int MoveSet_Count(const move_set_t* set) {
+  int i = 0;
+  int count = 0;
+
+  for (i = 0; i < MOVE_SET_WORDS; i++)
+    count += LMath_PopCount64(set->w[i]);
+
+  return count;
+}
+
+move_id_t MoveSet_Next(const move_set_t* set, int from) {
+  int i = from >> 6;
+  uint64_t word = 0;
+
+  if (from >= MOVE_COUNT)
+    return MOVE_NONE;
+
+  word = set->w[i] & (~(uint64_t)0 << (from & 63));
+
+  while (word == 0) {
+    if (++i >= MOVE_SET_WORDS)
+      return MOVE_NONE;
+
+    word = set->w[i];
+  }
+
+  return (move_id_t)((i << 6) + LMath_Ctz64(word));
+}
+
+/*
+ * ************************************************************
+ * move generator
+ * ************************************************************
+ */
+
+#define MOVE_CLASS_BOMB (MOVE_CLASS_COUNT - 2)
+#define MOVE_CLASS_NUKE (MOVE_CLASS_COUNT - 1)
+
+#define Move_Emit(moves, capacity, n, t, r, c, k)                              \
+  do {                                                                         \
+    if ((n) < (capacity)) {                                                    \
+      (moves)[(n)].type = (uint8_t)(t);                                        \
+      (moves)[(n)].rank = (uint8_t)(r);                                        \
+      (moves)[(n)].chain = (uint8_t)(c);                                       \
+      (moves)[(n)].pad = 0;                                                    \
+      (moves)[(n)].kicker = (uint16_t)(k);                                     \
+    }                                                                          \
+    (n)++;                                                                     \
+  } while (0)
+
+/*
+ * ranks that can hold the primal part and the kickers of class mc
+ */
+void _Move_ClassMasks(const rank_count_t* count, const _move_class_t* mc,
+                      uint16_t* avail, uint16_t* kickers) {
+  int dup = 0;
+  int kmax = 0;
+
+  /* bomb takes four cards like four */
+  dup = Hand_GetPrimal(mc->type);
+  dup = (dup > HAND_PRIMAL_FOUR) ? HAND_PRIMAL_FOUR : dup;
+  *avail = RankCount_MaskGE(count, dup);
+
+  if (mc->chain > 1)
+    *avail &= RANK_MASK_CHAIN;
+
+  /* pair kickers stop at 2 */
+  kmax = Move_KickerMaxRank(mc->type);
+  *kickers = RankCount_MaskGE(count, (kmax == CARD_RANK_2) ? 2 : 1);
+  *kickers &= (uint16_t)((1 << (kmax + 1)) - 2);
+}
+
+/*
+ * generate moves of class c from lead index lead upwards,
+ * n is the number of moves generated so far, return the new n
+ */
+int _Move_GenerateClass(const rank_count_t* count, int c, int lead,
+                        rank_hand_t* moves, int capacity, int n) {
+  int p = 0;
+  uint16_t run = 0;
+  uint16_t avail = 0;
+  uint16_t pool = 0;
+  uint16_t kickers = 0;
+  uint16_t kicker = 0;
+  uint32_t comb = 0;
+  uint32_t bits = 0;
+  uint32_t t = 0;
+  uint8_t ranks[CARD_RANK_END];
+  const _move_class_t* mc = &_move_classes[c];
+
+  if (mc->type == HAND_PRIMAL_NUKE) {
+    if ((lead == 0) && count->n[CARD_RANK_r] && count->n[CARD_RANK_R])
+      Move_Emit(moves, capacity, n, mc->type, CARD_RANK_R, 1, 0);
+
+    return n;
+  }
+
+  _Move_ClassMasks(count, mc, &avail, &kickers);
+
+  for (; lead < mc->leads; lead++) {
+    run = (uint16_t)(((1 << mc->chain) - 1) << (lead + 1));
+
+    if ((avail & run) != run)
+      continue;
+
+    if (mc->k == 0) {
+      Move_Emit(moves, capacity, n, mc->type, lead + mc->chain, mc->chain, 0);
+      continue;
+    }
+
+    /* kicker ranks this hand can take, ascending */
+    for (p = 0, pool = kickers & ~run; pool != 0; pool &= pool - 1)
+      ranks[p++] = (uint8_t)LMath_Ctz64(pool);
+
+    if (p < mc->k)
+      continue;
+
+    /* k-subsets of the pool in colex order, which is move id order */
+    for (comb = (1u << mc->k) - 1; comb < (1u << p);) {
+      kicker = 0;
+
+      for (bits = comb; bits != 0; bits &= bits - 1)
+        kicker |= (uint16_t)(1 << ranks[LMath_Ctz64(bits)]);
+
+      Move_Emit(moves, capacity, n, mc->type, lead + mc->chain, mc->chain,
+                kicker);
+
+      /* next subset of the same size */
+      t = comb | (comb - 1);
+      comb = (t + 1) | (((~t & (t + 1)) - 1) >> (LMath_Ctz64(comb) + 1));
+    }
+  }
+
+  return n;
+}
+
+int Move_Generate(const rank_count_t* count, const rank_hand_t* tobeat,
+                  rank_hand_t* moves, int capacity) {
+  int c = 0;
+  int n = 0;
+  int lead = 0;
+  move_id_t id = MOVE_NONE;
+  const _move_class_t* mc = NULL;
+
+  if ((tobeat == NULL) || (tobeat->type == 0)) {
+    for (c = 0; c < MOVE_CLASS_COUNT; c++)
+      n = _Move_GenerateClass(count, c, 0, moves, capacity, n);
+
+    return n;
+  }
+
+  id = Move_FromRankHand(tobeat);
+
+  if ((id == MOVE_NONE) || (id == MOVE_NUKE))
+    return 0;
+
+  /* higher leads of the same class */
+  c = _Move_ClassOf(id);
+  mc = &_move_classes[c];
+  lead = (id - mc->base) / MOVE_BINOMIAL(mc->m, mc->k) + 1;
+
+  if (c != MOVE_CLASS_BOMB) {
+    n = _Move_GenerateClass(count, c, lead, moves, capacity, n);
+    lead = 0;
+  }
+
+  /* bombs and nuke */
+  n = _Move_GenerateClass(count, MOVE_CLASS_BOMB, lead, moves, capacity, n);
+  n = _Move_GenerateClass(count, MOVE_CLASS_NUKE, 0, moves, capacity, n);
+
+  return n;
+}
+
+/*
+ * check if class c has a move from lead index lead upwards
+ */
+int _Move_ClassExists(const rank_count_t* count, int c, int lead) {
+  uint16_t run = 0;
+  uint16_t avail = 0;
+  uint16_t kickers = 0;
+  const _move_class_t* mc = &_move_classes[c];
+
+  if (mc->type == HAND_PRIMAL_NUKE)
+    return (lead == 0) && count->n[CARD_RANK_r] && count->n[CARD_RANK_R];
+
+  _Move_ClassMasks(count, mc, &avail, &kickers);
+
+  for (; lead < mc->leads; lead++) {
+    run = (uint16_t)(((1 << mc->chain) - 1) << (lead + 1));
+
+    if (((avail & run) == run) &&
+        (LMath_PopCount32(kickers & ~run) >= mc->k))
+      return 1;
+  }
+
+  return 0;
+}
+
+int Move_CanBeat(const rank_count_t* count, const rank_hand_t* tobeat) {
+  int c = 0;
+  int lead = 0;
+  move_id_t id = MOVE_NONE;
+  const _move_class_t* mc = NULL;
+
+  /* free play, anything goes */
+  if ((tobeat == NULL) || (tobeat->type == 0))
+    return (count->q[0] | count->q[1]) != 0;
+
+  id = Move_FromRankHand(tobeat);
+
+  if ((id == MOVE_NONE) || (id == MOVE_NUKE))
+    return 0;
+
+  c = _Move_ClassOf(id);
+  mc = &_move_classes[c];
+  lead = (id - mc->base) / MOVE_BINOMIAL(mc->m, mc->k) + 1;
+
+  if (c != MOVE_CLASS_BOMB) {
+    if (_Move_ClassExists(count, c, lead))
+      return 1;
+
+    lead = 0;
+  }
+
+  return _Move_ClassExists(count, MOVE_CLASS_BOMB, lead) ||
+         _Move_ClassExists(count, MOVE_CLASS_NUKE, 0);
+}
@@ -0,0 +1,176 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LANDLORD_MOVE_H_
+#define LANDLORD_MOVE_H_
+
+#include "hand.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * ************************************************************
+ * move
+ * ************************************************************
+ */
+
+/*
+ * every rank level hand has a dense move id
+ *
+ * moves are grouped in classes, a class is a hand type with a chain length
+ * inside a class, id = base + lead index * C(m, k) + colex rank of kickers
+ * where m is the number of ranks a kicker can take and k the kicker count,
+ * so a higher lead always has a higher id
+ *
+ * bombs and nuke come last, a move is beaten by the rest of its class
+ * above its lead and by every bomb above it, which is at most two id ranges
+ *
+ * kickers are distinct ranks other than the primal ranks,
+ * the same rule Hand_Parse follows
+ */
+typedef uint16_t move_id_t;
+
+#define MOVE_COUNT 34323
+#define MOVE_BOMB_BASE 34309
+#define MOVE_NUKE 34322
+#define MOVE_NONE 0xFFFF
+
+/* half open id range [begin, end) */
+typedef struct _move_range_s {
+  move_id_t begin;
+  move_id_t end;
+
+} move_range_t;
+
+#define MOVE_BEAT_RANGES 2
+
+/*
+ * move id of a rank hand, MOVE_NONE if it is not a legal move
+ */
+move_id_t Move_FromRankHand(const rank_hand_t* rh);
+
+/*
+ * move id of a hand, MOVE_NONE if it is not a legal move
+ */
+move_id_t Move_FromHand(hand_t* hand);
+
+/*
+ * rank hand of a move id, return 0 for invalid id
+ */
+int Move_ToRankHand(move_id_t id, rank_hand_t* rh);
+
+/*
+ * hand of a move id with cards taken from cards, return 0 on failure
+ */
+int Move_ToHand(move_id_t id, hand_t* hand, const uint8_t* cards, int length);
+
+/*
+ * id ranges of moves that beat id, return the number of ranges
+ */
+int Move_BeatRanges(move_id_t id, move_range_t* ranges);
+
+/*
+ * check if move a beats move b
+ */
+int Move_Beats(move_id_t a, move_id_t b);
+
+/*
+ * ************************************************************
+ * move set
+ * ************************************************************
+ */
+
+#define MOVE_SET_WORDS ((MOVE_COUNT + 63) / 64)
+
+/* one bit per move id */
+typedef struct _move_set_s {
+  uint64_t w[MOVE_SET_WORDS];
+
+} move_set_t;
+
+#define MoveSet_Clear(s) memset((s), 0, sizeof(move_set_t))
+#define MoveSet_Copy(d, s) memcpy((d), (s), sizeof(move_set_t))
+#define MoveSet_Add(s, id) ((s)->w[(id) >> 6] |= (uint64_t)1 << ((id)&63))
+#define MoveSet_Remove(s, id) ((s)->w[(id) >> 6] &= ~((uint64_t)1 << ((id)&63)))
+#define MoveSet_Has(s, id) (((s)->w[(id) >> 6] >> ((id)&63)) & 1)
+
+/*
+ * add ids in [begin, end)
+ */
+void MoveSet_AddRange(move_set_t* set, move_id_t begin, move_id_t end);
+
+/*
+ * add every move that beats id
+ */
+void MoveSet_AddBeats(move_set_t* set, move_id_t id);
+
+/*
+ * dst = a & b
+ */
+void MoveSet_And(move_set_t* dst, const move_set_t* a, const move_set_t* b);
+
+/*
+ * dst = moves in candidates that beat id, only words in beat ranges are read
+ */
+void MoveSet_AndBeats(move_set_t* dst, const move_set_t* candidates,
+                      move_id_t id);
+
+/*
+ * ************************************************************
+ * move generator
+ * ************************************************************
+ */
+
+/*
+ * write every legal play of count into moves, in ascending move id order,
+ * if tobeat is not NULL only plays that beat it are generated
+ * at most capacity plays are written, return the total number of plays
+ * so a short buffer can be retried, no memory is allocated
+ */
+int Move_Generate(const rank_count_t* count, const rank_hand_t* tobeat,
+                  rank_hand_t* moves, int capacity);
+
+/*
+ * check if count holds a play that beats tobeat, without building it
+ * return 0 if tobeat is not a legal move
+ */
+int Move_CanBeat(const rank_count_t* count, const rank_hand_t* tobeat);
+
+/*
+ * number of ids in set
+ */
+int MoveSet_Count(const move_set_t* set);
+
+/*
+ * first id in set not less than from, MOVE_NONE if none
+ */
+move_id_t MoveSet_Next(const move_set_t* set, int from);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LANDLORD_MOVE_H_ */
@@ -42,16 +42,16 @@ void Player_SetupAdvancedAI(player_t* player) {
 }
 
 void Player_Destroy(player_t* player) {
-  rk_list_clear_destroy(player->handlist);
   free(player);
 }
 
 void Player_Clear(player_t* player) {
-  rk_list_clear_destroy(player->handlist);
-  player->handlist = NULL;
+  HandList_Clear(&player->handlist);
+  HandIndex_Build(&player->handindex, &player->handlist);
   player->identity = PlayerIdentity_Peasant;
   CardArray_Clear(&player->cards);
   CardArray_Clear(&player->record);
+  HandCtx_Clear(&player->ctx);
 }
 
 int Player_HandleEvent(void* p, int event, void* game) {
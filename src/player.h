@@ -58,12 +58,14 @@ typedef enum {
 typedef int (*PlayerEventHandler)(void* player, void* context);
 
 typedef struct player_s {
-  card_array_t cards;  /* card array, will change during game play */
-  card_array_t record; /* card record */
-  rk_list_t* handlist; /* the analyze result of cards */
-  int identity;        /* 0: peasant, 1: landlord */
-  int seatId;          /* 0, 1, 2 */
-  int bid;             /* 0, 1, 2, 3 */
+  card_array_t cards;     /* card array, will change during game play */
+  card_array_t record;    /* card record */
+  hand_ctx_t ctx;         /* search context, in sync with cards */
+  hand_list_t handlist;   /* the analyze result of cards */
+  hand_index_t handindex; /* handlist by type */
+  int identity;           /* 0: peasant, 1: landlord */
+  int seatId;             /* 0, 1, 2 */
+  int bid;                /* 0, 1, 2, 3 */
 
   PlayerEventHandler eventHandlers[Player_Event_Count];
 
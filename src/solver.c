@@ -0,0 +1,247 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "solver.h"
+#include "lmath.h"
+
+#define SOLVER_TABLE_INIT 4096
+#define SOLVER_MOVES_INIT 1024
+
+/* 3 bits per rank lane, same layout as the evaluator cache */
+#define SOLVER_LANE_BITS 3
+
+/* fibonacci hashing, linear probing */
+#define SOLVER_HASH(k) ((uint32_t)(((k)*0x9E3779B97F4A7C15ull) >> 32))
+
+#define Solver_PlayCost(s, rh) ((s)->cost != NULL ? (s)->cost(rh) : 1)
+
+uint64_t _Solver_Key(const rank_count_t* count) {
+  int i = 0;
+  uint64_t key = 0;
+
+  for (i = CARD_RANK_BEG; i < CARD_RANK_END; i++)
+    key |= (uint64_t)count->n[i] << (i * SOLVER_LANE_BITS);
+
+  return key;
+}
+
+solver_entry_t* _Solver_Find(solver_t* solver, uint64_t key) {
+  uint32_t mask = solver->capacity - 1;
+  uint32_t i = SOLVER_HASH(key) & mask;
+
+  while (solver->table[i].key != 0 && solver->table[i].key != key)
+    i = (i + 1) & mask;
+
+  return &solver->table[i];
+}
+
+void _Solver_Grow(solver_t* solver) {
+  uint32_t i = 0;
+  uint32_t capacity = solver->capacity;
+  solver_entry_t* table = solver->table;
+
+  solver->capacity = capacity * 2;
+  solver->table =
+      (solver_entry_t*)calloc(solver->capacity, sizeof(solver_entry_t));
+
+  for (i = 0; i < capacity; i++) {
+    if (table[i].key != 0)
+      memcpy(_Solver_Find(solver, table[i].key), &table[i],
+             sizeof(solver_entry_t));
+  }
+
+  free(table);
+}
+
+void _Solver_Store(solver_t* solver, uint64_t key, int cost, move_id_t move) {
+  solver_entry_t* entry = NULL;
+
+  /* keep load under 1/2 */
+  if ((solver->count + 1) * 2 > solver->capacity)
+    _Solver_Grow(solver);
+
+  entry = _Solver_Find(solver, key);
+
+  if (entry->key == 0) {
+    entry->key = key;
+    solver->count++;
+  }
+
+  entry->cost = cost;
+  entry->move = move;
+}
+
+/*
+ * generate plays of count that take rank low on top of the move stack,
+ * return the number of plays
+ */
+int _Solver_Generate(solver_t* solver, const rank_count_t* count, int low) {
+  int i = 0;
+  int n = 0;
+  int base = solver->movetop;
+  int total = 0;
+  rank_count_t used;
+  rank_hand_t* moves = NULL;
+
+  total = Move_Generate(count, NULL, solver->moves + base,
+                        solver->movecap - base);
+
+  /* short buffer, grow and retry */
+  if (total > solver->movecap - base) {
+    while (solver->movecap < base + total)
+      solver->movecap *= 2;
+
+    solver->moves = (rank_hand_t*)realloc(
+        solver->moves, sizeof(rank_hand_t) * solver->movecap);
+    Move_Generate(count, NULL, solver->moves + base, solver->movecap - base);
+  }
+
+  moves = solver->moves + base;
+
+  for (i = 0; i < total; i++) {
+    RankHand_Count(&moves[i], &used);
+
+    if (used.n[low] != 0)
+      RankHand_Copy(&moves[n++], &moves[i]);
+  }
+
+  return n;
+}
+
+int _Solver_Search(solver_t* solver, const rank_count_t* count) {
+  int i = 0;
+  int n = 0;
+  int base = 0;
+  int cost = 0;
+  int best = -1;
+  uint64_t key = _Solver_Key(count);
+  move_id_t move = MOVE_NONE;
+  solver_entry_t* entry = NULL;
+  rank_hand_t rh;
+  rank_count_t used;
+  rank_count_t next;
+
+  if (key == 0)
+    return 0;
+
+  entry = _Solver_Find(solver, key);
+
+  if (entry->key == key)
+    return entry->cost;
+
+  /* a solo of the lowest rank is always there, n > 0 */
+  base = solver->movetop;
+  n = _Solver_Generate(solver, count,
+                       LMath_Ctz64(RankCount_MaskGE(count, 1)));
+  solver->movetop = base + n;
+
+  for (i = 0; i < n; i++) {
+    /* the move stack may be reallocated by deeper states */
+    RankHand_Copy(&rh, &solver->moves[base + i]);
+    RankHand_Count(&rh, &used);
+    RankCount_Sub(&next, count, &used);
+
+    cost = Solver_PlayCost(solver, &rh) + _Solver_Search(solver, &next);
+
+    /* plays are in ascending id order, strict < keeps the lowest id on tie */
+    if (best < 0 || cost < best) {
+      best = cost;
+      move = Move_FromRankHand(&rh);
+    }
+  }
+
+  solver->movetop = base;
+  _Solver_Store(solver, key, best, move);
+
+  return best;
+}
+
+void Solver_Init(solver_t* solver, solver_cost_func cost) {
+  memset(solver, 0, sizeof(solver_t));
+
+  solver->cost = cost;
+  solver->capacity = SOLVER_TABLE_INIT;
+  solver->table =
+      (solver_entry_t*)calloc(solver->capacity, sizeof(solver_entry_t));
+  solver->movecap = SOLVER_MOVES_INIT;
+  solver->moves = (rank_hand_t*)malloc(sizeof(rank_hand_t) * solver->movecap);
+}
+
+void Solver_Destroy(solver_t* solver) {
+  free(solver->table);
+  free(solver->moves);
+  memset(solver, 0, sizeof(solver_t));
+}
+
+void Solver_Clear(solver_t* solver) {
+  memset(solver->table, 0, sizeof(solver_entry_t) * solver->capacity);
+  solver->count = 0;
+}
+
+int Solver_Solve(solver_t* solver, const rank_count_t* count,
+                 rank_hand_t* plays, int* length) {
+  int n = 0;
+  int cost = 0;
+  uint64_t key = 0;
+  rank_count_t state;
+  rank_count_t used;
+
+  cost = _Solver_Search(solver, count);
+
+  /* follow the best first plays, every state on the way is memoised */
+  if (plays != NULL) {
+    RankCount_Copy(&state, count);
+
+    while ((key = _Solver_Key(&state)) != 0 && n < SOLVER_PLAYS_MAX) {
+      Move_ToRankHand(_Solver_Find(solver, key)->move, &plays[n]);
+      RankHand_Count(&plays[n], &used);
+      RankCount_Sub(&state, &state, &used);
+      n++;
+    }
+  }
+
+  if (length != NULL)
+    *length = n;
+
+  return cost;
+}
+
+void Solver_Analyze(solver_t* solver, card_array_t* array, hand_list_t* hl) {
+  int i = 0;
+  int length = 0;
+  rank_hand_t plays[SOLVER_PLAYS_MAX];
+  card_array_t cards;
+  hand_t hand;
+
+  HandList_Clear(hl);
+
+  Solver_Solve(solver, &array->ranks, plays, &length);
+  CardArray_Copy(&cards, array);
+
+  for (i = 0; i < length; i++) {
+    RankHand_ToHand(&plays[i], &hand, cards.cards, cards.length);
+    CardArray_SubtractHand(&cards, &hand.cards);
+    HandList_PushBack(hl, &hand);
+  }
+}
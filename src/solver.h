@@ -0,0 +1,113 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LANDLORD_SOLVER_H_
+#define LANDLORD_SOLVER_H_
+
+#include "handlist.h"
+#include "move.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * ************************************************************
+ * exact solver
+ * ************************************************************
+ */
+
+/*
+ * minimum cost decomposition of rank counts into legal plays
+ *
+ * every legal move is considered, kickers included, the cost of a state is
+ * the best over plays that take its lowest rank, which some play of any
+ * decomposition must do, plus the cost of what is left
+ *
+ * states are memoised in a hash table that lives as long as the solver,
+ * so later calls reuse what earlier calls solved
+ */
+
+/* at most one play per card */
+#define SOLVER_PLAYS_MAX HAND_MAX_LENGTH
+
+/* cost of a play, must not be negative */
+typedef int (*solver_cost_func)(rank_hand_t* hand);
+
+/* memo entry, key 0 is empty, the empty state is never stored */
+typedef struct _solver_entry_s {
+  uint64_t key;
+  int32_t cost;
+  move_id_t move; /* first play of the best decomposition */
+  uint16_t pad;
+
+} solver_entry_t;
+
+typedef struct _solver_s {
+  solver_cost_func cost;
+
+  /* memo, capacity is a power of 2 */
+  solver_entry_t* table;
+  uint32_t capacity;
+  uint32_t count;
+
+  /* generated plays of every state on the search path */
+  rank_hand_t* moves;
+  int movecap;
+  int movetop;
+
+} solver_t;
+
+/*
+ * init solver, cost NULL counts one per play
+ */
+void Solver_Init(solver_t* solver, solver_cost_func cost);
+
+/*
+ * free memo and buffers
+ */
+void Solver_Destroy(solver_t* solver);
+
+/*
+ * drop memo
+ */
+void Solver_Clear(solver_t* solver);
+
+/*
+ * minimum cost to play out count, the plays are stored in plays when it is
+ * not NULL, at most SOLVER_PLAYS_MAX, and their number in length
+ */
+int Solver_Solve(solver_t* solver, const rank_count_t* count,
+                 rank_hand_t* plays, int* length);
+
+/*
+ * minimum cost decomposition of cards as a hand list
+ */
+void Solver_Analyze(solver_t* solver, card_array_t* array, hand_list_t* hl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LANDLORD_SOLVER_H_ */
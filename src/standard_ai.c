@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include "standard_ai.h"
+#include "evalcache.h"
 #include "game.h"
 
 int StandardAI_GetReady(void* p, void* game) {
@@ -30,10 +31,12 @@ int StandardAI_GetReady(void* p, void* game) {
 
   CardArray_Sort(&player->cards, NULL);
   CardArray_Copy(&player->record, &player->cards);
+  HandCtx_Setup(&player->ctx, &player->cards);
 #if (PRINT_GAME_LOG == 1)
   CardArray_Print(&player->record);
 #endif /* ifdef PRINT_GAME_LOG */
-  player->handlist = HandList_StandardAnalyze(&player->cards);
+  HandList_StandardAnalyze(&player->cards, &player->handlist);
+  HandIndex_Build(&player->handindex, &player->handlist);
 
   return 0;
 }
@@ -45,9 +48,8 @@ int StandardAI_Bid(void* p, void* g) {
   player_t* player = (player_t*)p;
 
   CardArray_Sort(&player->cards, NULL);
-  player->handlist = HandList_StandardAnalyze(&player->cards);
-  handlistlen = rk_list_count(player->handlist);
-  rk_list_clear_destroy(player->handlist);
+  HandList_StandardAnalyze(&player->cards, &player->handlist);
+  handlistlen = HandList_Length(&player->handlist);
 
   if (handlistlen > 9) {
     shouldbid = 0;
@@ -72,28 +74,29 @@ int StandardAI_Play(void* p, void* game) {
   int searchprimal = 0;
   int kicker = 0;
   player_t* player = (player_t*)p;
+  hand_list_t* handlist = &player->handlist;
+  hand_index_t* index = &player->handindex;
   hand_t* node = NULL;
-  rk_list_node_t* temp = NULL;
 
   hand_t* hand = &((game_t*)game)->lastHand;
 
   do {
     /* empty hands */
-    if (player->handlist == NULL) {
+    if (HandList_IsEmpty(handlist)) {
       hand->type = 0;
       break;
     }
 
     /* last hand */
-    if (rk_list_count(player->handlist) == 1) {
-      Hand_Copy(hand, (hand_t*)player->handlist->first->payload);
-      HandList_Remove(player->handlist, player->handlist->first->payload);
+    if (HandList_Length(handlist) == 1) {
+      Hand_Copy(hand, HandList_Get(handlist, 0));
+      HandIndex_Remove(index, handlist, HandList_Get(handlist, 0));
       break;
     }
 
     /* try to find longest hand combination */
-    node = HandList_Find(
-        player->handlist,
+    node = HandIndex_Highest(
+        index, handlist,
         Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAIN));
 
     if (node != NULL) {
@@ -104,21 +107,11 @@ int StandardAI_Play(void* p, void* game) {
       need = node->cards.length / 3;
 
       /* remove hand node from hand list */
-      HandList_Remove(player->handlist, node);
+      HandIndex_Remove(index, handlist, node);
 
       /* count solo and pair number */
-      temp = player->handlist->first;
-      countpair = 0;
-      countsolo = 0;
-
-      while (temp->next != NULL) {
-        if (HandList_GetHand(temp)->type == HAND_PRIMAL_PAIR)
-          countpair++;
-        else if (HandList_GetHand(temp)->type == HAND_PRIMAL_SOLO)
-          countsolo++;
-
-        temp = temp->next;
-      }
+      countpair = HandIndex_Count(index, HAND_PRIMAL_PAIR);
+      countsolo = HandIndex_Count(index, HAND_PRIMAL_SOLO);
 
       /* trio-pair-chain then trio-solo-chain */
       if ((countsolo < need) && (countpair < need)) {
@@ -131,20 +124,16 @@ int StandardAI_Play(void* p, void* game) {
         kicker = HAND_KICKER_SOLO;
       }
 
-      /* detach pairs from list */
-      temp = player->handlist->first;
-
-      while (need > 0 && temp != NULL) {
-        if (HandList_GetHand(temp)->type ==
-            Hand_Format(searchprimal, HAND_KICKER_NONE, HAND_CHAINLESS)) {
-          /* copy cards */
-          CardArray_Concat(&hand->cards, &HandList_GetHand(temp)->cards);
-          HandList_Remove(player->handlist, temp->payload);
-          temp = player->handlist->first;
-          need--;
-        } else {
-          temp = temp->next;
-        }
+      /* detach pairs from list, highest first */
+      while (need > 0) {
+        node = HandIndex_Highest(
+            index, handlist,
+            Hand_Format(searchprimal, HAND_KICKER_NONE, HAND_CHAINLESS));
+
+        /* copy cards */
+        CardHand_Concat(&hand->cards, &node->cards);
+        HandIndex_Remove(index, handlist, node);
+        need--;
       }
 
       Hand_SetKicker(hand->type, kicker);
@@ -152,42 +141,42 @@ int StandardAI_Play(void* p, void* game) {
     }
 
     /* pair chain */
-    node = HandList_Find(
-        player->handlist,
+    node = HandIndex_Highest(
+        index, handlist,
         Hand_Format(HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN));
 
     /* solo chain */
     if (node == NULL)
-      node = HandList_Find(
-          player->handlist,
+      node = HandIndex_Highest(
+          index, handlist,
           Hand_Format(HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN));
 
     if (node != NULL) {
       Hand_Copy(hand, node);
-      HandList_Remove(player->handlist, node);
+      HandIndex_Remove(index, handlist, node);
       break;
     }
 
     /* trio */
-    node = HandList_Find(
-        player->handlist,
+    node = HandIndex_Highest(
+        index, handlist,
         Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAINLESS));
 
     if ((node != NULL) && (CARD_RANK(node->cards.cards[0]) != CARD_RANK_2)) {
       Hand_Copy(hand, node);
-      HandList_Remove(player->handlist, node);
+      HandIndex_Remove(index, handlist, node);
 
       /* pair */
-      node = HandList_Find(
-          player->handlist,
+      node = HandIndex_Highest(
+          index, handlist,
           Hand_Format(HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAINLESS));
 
       if ((node != NULL) && (CARD_RANK(node->cards.cards[0]) != CARD_RANK_2)) {
         kicker = HAND_KICKER_PAIR;
       } else {
         /* solo */
-        node = HandList_Find(
-            player->handlist,
+        node = HandIndex_Highest(
+            index, handlist,
             Hand_Format(HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAINLESS));
 
         if ((node != NULL) && (CARD_RANK(node->cards.cards[0]) < CARD_RANK_2))
@@ -195,9 +184,9 @@ int StandardAI_Play(void* p, void* game) {
       }
 
       if (node != NULL) {
-        CardArray_Concat(&hand->cards, &node->cards);
+        CardHand_Concat(&hand->cards, &node->cards);
         Hand_SetKicker(hand->type, kicker);
-        HandList_Remove(player->handlist, node);
+        HandIndex_Remove(index, handlist, node);
         break;
       }
 
@@ -206,23 +195,23 @@ int StandardAI_Play(void* p, void* game) {
     }
 
     /* pair */
-    node = HandList_Find(
-        player->handlist,
+    node = HandIndex_Highest(
+        index, handlist,
         Hand_Format(HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAINLESS));
 
     if ((node != NULL) && (CARD_RANK(node->cards.cards[0]) != CARD_RANK_2)) {
       Hand_Copy(hand, node);
-      HandList_Remove(player->handlist, node);
+      HandIndex_Remove(index, handlist, node);
       break;
     }
 
     /* just play */
-    node = player->handlist->first->payload;
-    Hand_Copy(hand, node);
-    HandList_Remove(player->handlist, node);
+    Hand_Copy(hand, HandList_Get(handlist, 0));
+    HandIndex_Remove(index, handlist, HandList_Get(handlist, 0));
   } while (0);
 
-  CardArray_Subtract(&player->cards, &hand->cards);
+  CardArray_SubtractHand(&player->cards, &hand->cards);
+  HandCtx_Remove(&player->ctx, &hand->cards);
 
   return 0;
 }
@@ -246,7 +235,12 @@ int StandardAI_Beat(void* p, void* g) {
 
   tobeat = &((game_t*)game)->lastHand;
 
-  canbeat = HandList_BestBeat(&player->cards, tobeat, &beat, NULL);
+  /* nothing can beat it, pass without searching */
+  if (!HandList_CanBeat(&player->cards, tobeat))
+    return 0;
+
+  canbeat = HandList_BestBeatCtx(&player->ctx, tobeat, &beat,
+                                 EvalCache_StandardEvaluator);
 
   /*
      canbeat = HandList_SearchBeat(&player->cards, tobeat, &beat);
@@ -280,9 +274,10 @@ int StandardAI_Beat(void* p, void* g) {
   }
 
   if (canbeat) {
-    CardArray_Subtract(&player->cards, &beat.cards);
-    rk_list_clear_destroy(player->handlist);
-    player->handlist = HandList_StandardAnalyze(&player->cards);
+    CardArray_SubtractHand(&player->cards, &beat.cards);
+    HandCtx_Remove(&player->ctx, &beat.cards);
+    HandList_StandardAnalyze(&player->cards, &player->handlist);
+    HandIndex_Build(&player->handindex, &player->handlist);
     Hand_Copy(tobeat, &beat);
   }
 
@@ -0,0 +1,50 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef LANDLORD_TEST_H_
+#define LANDLORD_TEST_H_
+
+#include "landlord.h"
+
+/* failed checks printed at most, the rest are only counted */
+#define TEST_REPORT_MAX 20
+
+static int _test_failures = 0;
+
+/* count a failed check and print the first few */
+#define Test_Check(cond, ...)                                                  \
+  do {                                                                         \
+    if (!(cond) && ++_test_failures <= TEST_REPORT_MAX) {                      \
+      printf("%s:%d: ", __FILE__, __LINE__);                                   \
+      printf(__VA_ARGS__);                                                     \
+      printf("\n");                                                            \
+    }                                                                          \
+  } while (0)
+
+/* print the result of a test and give its exit code */
+#define Test_Result(name)                                                      \
+  (printf("%s: %d failed checks\n", (name), _test_failures),                   \
+   _test_failures != 0)
+
+#endif /* LANDLORD_TEST_H_ */
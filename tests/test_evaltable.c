@@ -0,0 +1,206 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * evaluator table checks
+ *
+ * the dense index must be a bijection between the first EvalTable_Size(n)
+ * indices and the rank counts with up to n cards, and a small generated
+ * table must give the same values as the live evaluators on every state
+ */
+
+#include <unistd.h>
+
+#include "test.h"
+
+/* cards of the states enumerated for the index */
+#define TEST_INDEX_CARDS 8
+/* cards of the generated tables, every state is evaluated */
+#define TEST_TABLE_CARDS 8
+
+/* cards of a rank lane, as the table */
+#define _Test_LaneMax(rank) ((rank) < CARD_RANK_r ? 4 : 1)
+
+static uint64_t _test_states = 0;
+
+/* visit every rank count with up to cards cards from rank up */
+void _Test_Enumerate(rank_count_t* ranks, int rank, int cards) {
+  int v = 0;
+  int64_t index = 0;
+  rank_count_t back;
+
+  if (rank == CARD_RANK_END) {
+    _test_states++;
+    index = EvalTable_Index(ranks);
+
+    Test_Check(index >= 0 &&
+                   (uint64_t)index < EvalTable_Size(TEST_INDEX_CARDS),
+               "state %llu indexed out of range",
+               (unsigned long long)_test_states);
+
+    if (index >= 0)
+      Test_Check(EvalTable_Unrank((uint64_t)index, &back) &&
+                     memcmp(&back, ranks, sizeof(rank_count_t)) == 0,
+                 "index %lld doesn't unrank to its state", (long long)index);
+    return;
+  }
+
+  for (v = 0; v <= _Test_LaneMax(rank) && v <= cards; v++) {
+    ranks->n[rank] = (uint8_t)v;
+    _Test_Enumerate(ranks, rank + 1, cards - v);
+  }
+
+  ranks->n[rank] = 0;
+}
+
+void Test_Index(void) {
+  int i = 0;
+  int s = 0;
+  uint64_t index = 0;
+  uint64_t n = EvalTable_Size(TEST_INDEX_CARDS);
+  rank_count_t ranks;
+
+  /* every state maps into range and back, so the index is injective */
+  RankCount_Clear(&ranks);
+  _Test_Enumerate(&ranks, CARD_RANK_BEG, TEST_INDEX_CARDS);
+
+  /* as many indices as states, so it is a bijection */
+  Test_Check(_test_states == n, "%llu states but %llu indices",
+             (unsigned long long)_test_states, (unsigned long long)n);
+
+  /* every index unranks to a state that indexes back to it */
+  for (index = 0; index < n; index++) {
+    Test_Check(EvalTable_Unrank(index, &ranks) &&
+                   EvalTable_Index(&ranks) == (int64_t)index,
+               "index %llu doesn't round trip", (unsigned long long)index);
+
+    for (i = CARD_RANK_BEG, s = 0; i < CARD_RANK_END; i++)
+      s += ranks.n[i];
+
+    /* states are ordered by card count */
+    Test_Check(index >= EvalTable_Size(s - 1) && index < EvalTable_Size(s),
+               "index %llu has %d cards out of order",
+               (unsigned long long)index, s);
+  }
+
+  Test_Check(EvalTable_Size(-1) == 0 && EvalTable_Size(0) == 1,
+             "empty table sizes");
+  Test_Check(!EvalTable_Unrank(EvalTable_Size(EVAL_TABLE_CARDS_MAX), &ranks),
+             "index past the last state unranks");
+
+  RankCount_Clear(&ranks);
+  ranks.n[CARD_RANK_r] = 2;
+  Test_Check(EvalTable_Index(&ranks) == -1, "two red jokers indexed");
+}
+
+/* live value of a state */
+int _Test_Evaluate(int evaluator, const rank_count_t* ranks) {
+  card_array_t array;
+
+  CardArray_FromRanks(&array, ranks);
+
+  return evaluator == EVAL_CACHE_ADVANCED ? HandList_AdvancedEvaluator(&array)
+                                          : HandList_StandardEvaluator(&array);
+}
+
+/* write a table as tools/evaltable_gen.c does, return 0 on failure */
+int _Test_WriteTable(int fd, int evaluator, int cards) {
+  uint64_t i = 0;
+  uint64_t n = EvalTable_Size(cards);
+  uint8_t value = 0;
+  FILE* fp = NULL;
+  eval_table_header_t header;
+  rank_count_t ranks;
+
+  memset(&header, 0, sizeof(eval_table_header_t));
+  memcpy(header.magic, EVAL_TABLE_MAGIC, sizeof(EVAL_TABLE_MAGIC));
+  header.version = EVAL_TABLE_VERSION;
+  header.evaluator = (uint32_t)evaluator;
+  header.cards = (uint32_t)cards;
+  header.count = n;
+
+  fp = fdopen(fd, "wb");
+
+  if (fp == NULL)
+    return 0;
+
+  fwrite(&header, sizeof(eval_table_header_t), 1, fp);
+
+  for (i = 0; i < n; i++) {
+    EvalTable_Unrank(i, &ranks);
+    value = (uint8_t)_Test_Evaluate(evaluator, &ranks);
+    fwrite(&value, 1, 1, fp);
+  }
+
+  return !(ferror(fp) | fclose(fp));
+}
+
+void Test_Table(int evaluator) {
+  int fd = -1;
+  int value = 0;
+  uint64_t i = 0;
+  uint64_t n = EvalTable_Size(TEST_TABLE_CARDS);
+  char path[] = "/tmp/landlord_test_XXXXXX";
+  rank_count_t ranks;
+
+  fd = mkstemp(path);
+  Test_Check(fd >= 0, "can't create a temporary table");
+
+  if (fd < 0)
+    return;
+
+  Test_Check(_Test_WriteTable(fd, evaluator, TEST_TABLE_CARDS),
+             "can't write table %d", evaluator);
+  Test_Check(EvalTable_Open(path) == evaluator, "can't open table %d",
+             evaluator);
+  unlink(path);
+
+  for (i = 0; i < n; i++) {
+    EvalTable_Unrank(i, &ranks);
+    value = -1;
+
+    Test_Check(EvalTable_Lookup(evaluator, &ranks, &value) &&
+                   value == _Test_Evaluate(evaluator, &ranks),
+               "table %d index %llu gives %d", evaluator,
+               (unsigned long long)i, value);
+  }
+
+  /* states past the table are not covered */
+  EvalTable_Unrank(n, &ranks);
+  Test_Check(!EvalTable_Lookup(evaluator, &ranks, &value),
+             "table %d covers index %llu", evaluator, (unsigned long long)n);
+
+  EvalTable_Close();
+  EvalTable_Unrank(n - 1, &ranks);
+  Test_Check(!EvalTable_Lookup(evaluator, &ranks, &value),
+             "table %d still covers after close", evaluator);
+}
+
+int main(void) {
+  Test_Index();
+  Test_Table(EVAL_CACHE_STANDARD);
+  Test_Table(EVAL_CACHE_ADVANCED);
+
+  return Test_Result("evaltable");
+}
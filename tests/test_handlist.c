@@ -0,0 +1,147 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * hand list checks
+ *
+ * the parallel advanced analyze must give the same hand list as the serial
+ * one for any number of workers, and the batch standard evaluator must give
+ * the scalar values, partial last batches included
+ */
+
+#include "test.h"
+
+#define TEST_DEALS 3000
+#define TEST_DEAL_MIN 14
+#define TEST_DEAL_MAX 20
+#define TEST_WORKERS_MIN 2
+#define TEST_WORKERS_MAX 7
+#define TEST_BATCHES 20000
+#define TEST_BATCH_MAX 40
+
+/* same hands in the same order, cards included */
+int _Test_SameList(hand_list_t* a, hand_list_t* b) {
+  int i = 0;
+  hand_t* x = NULL;
+  hand_t* y = NULL;
+
+  if (a->length != b->length)
+    return 0;
+
+  for (i = 0; i < a->length; i++) {
+    x = HandList_Get(a, i);
+    y = HandList_Get(b, i);
+
+    if (x->type != y->type || x->cards.length != y->cards.length ||
+        memcmp(x->cards.cards, y->cards.cards, x->cards.length) != 0)
+      return 0;
+  }
+
+  return 1;
+}
+
+/* deal length cards off a shuffled deck */
+void _Test_Deal(mt19937_t* mt, card_array_t* array, int length) {
+  card_array_t deck;
+
+  CardArray_Reset(&deck);
+  LMath_Shuffle(deck.cards, deck.length, mt);
+  CardArray_Clear(array);
+
+  while (array->length < length)
+    CardArray_PushBack(array, deck.cards[array->length]);
+}
+
+void Test_Parallel(mt19937_t* mt) {
+  int i = 0;
+  int length = 0;
+  int workers = 0;
+  card_array_t array;
+  card_array_t copy;
+  hand_list_t serial;
+  hand_list_t parallel;
+
+  for (i = 0; i < TEST_DEALS; i++) {
+    length = TEST_DEAL_MIN +
+             (int)(Random_uint32(mt) % (TEST_DEAL_MAX - TEST_DEAL_MIN + 1));
+    workers = TEST_WORKERS_MIN + i % (TEST_WORKERS_MAX - TEST_WORKERS_MIN + 1);
+    _Test_Deal(mt, &array, length);
+
+    CardArray_Copy(&copy, &array);
+    HandList_AdvancedAnalyze(&copy, &serial);
+    CardArray_Copy(&copy, &array);
+    HandList_AdvancedAnalyzeParallel(&copy, &parallel, workers);
+
+    Test_Check(_Test_SameList(&serial, &parallel),
+               "deal %d of %d cards, %d workers: %d hands, serial %d", i,
+               length, workers, parallel.length, serial.length);
+  }
+}
+
+void Test_Batch(mt19937_t* mt) {
+  int i = 0;
+  int j = 0;
+  int r = 0;
+  int count = 0;
+  int expect = 0;
+  card_array_t array;
+  rank_count_t ranks;
+  rank_count_t deltas[TEST_BATCH_MAX];
+  int values[TEST_BATCH_MAX];
+
+  for (i = 0; i < TEST_BATCHES; i++) {
+    _Test_Deal(mt, &array,
+               1 + (int)(Random_uint32(mt) % CARD_HAND_PRESET_LENGTH));
+    count = (int)(Random_uint32(mt) % (TEST_BATCH_MAX + 1));
+
+    /* random sub counts of the deal, as plays taken out of a hand */
+    for (j = 0; j < count; j++) {
+      RankCount_Clear(&deltas[j]);
+
+      for (r = CARD_RANK_BEG; r < CARD_RANK_END; r++)
+        deltas[j].n[r] = (uint8_t)(Random_uint32(mt) % (array.ranks.n[r] + 1));
+    }
+
+    HandList_StandardEvaluatorBatch(&array.ranks, deltas, count, values);
+
+    for (j = 0; j < count; j++) {
+      RankCount_Sub(&ranks, &array.ranks, &deltas[j]);
+      expect = HandList_StandardEvaluatorRanks(&ranks);
+      Test_Check(values[j] == expect,
+                 "batch %d candidate %d of %d gives %d, not %d", i, j, count,
+                 values[j], expect);
+    }
+  }
+}
+
+int main(void) {
+  mt19937_t mt;
+
+  Random_Init(&mt, 20141024);
+
+  Test_Parallel(&mt);
+  Test_Batch(&mt);
+
+  return Test_Result("handlist");
+}
@@ -0,0 +1,405 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * move universe checks
+ *
+ * every move is enumerated from the hand rules, independently of the class
+ * table, and must map to a distinct id that converts back, with the ids of
+ * a class contiguous and the whole universe dense. readings of card arrays
+ * must round trip through move ids, and the beat relation must agree with
+ * Hand_CompareKey. generated plays must be what brute force over the
+ * universe finds
+ */
+
+#include "test.h"
+
+#define TEST_RANDOM_PAIRS 200000
+#define TEST_RANDOM_COUNTS 20000
+#define TEST_READINGS 32
+#define TEST_GENERATE_COUNTS 3000
+
+/* every legal hand type but bomb and nuke, which are enumerated apart */
+const uint8_t _test_types[] = {
+    Hand_Format(HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_PAIR, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_SOLO, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_PAIR, HAND_CHAINLESS),
+    Hand_Format(HAND_PRIMAL_SOLO, HAND_KICKER_NONE, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_PAIR, HAND_KICKER_NONE, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_NONE, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_SOLO, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_TRIO, HAND_KICKER_PAIR, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_FOUR, HAND_KICKER_NONE, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_SOLO, HAND_CHAIN),
+    Hand_Format(HAND_PRIMAL_FOUR, HAND_KICKER_DUAL_PAIR, HAND_CHAIN)};
+
+#define TEST_TYPES (int)(sizeof(_test_types) / sizeof(_test_types[0]))
+
+static uint8_t _test_seen[MOVE_COUNT];
+static rank_hand_t _test_moves[MOVE_COUNT];
+
+/* cards of one primal rank, solo to four are numbered by their cards */
+#define _Test_PrimalCards(type) Hand_GetPrimal(type)
+
+/* kicker ranks per primal rank and cards per kicker rank */
+void _Test_Kicker(int type, int* ranks, int* cards) {
+  int kicker = Hand_GetKicker(type);
+
+  *ranks = (kicker == HAND_KICKER_DUAL_SOLO || kicker == HAND_KICKER_DUAL_PAIR)
+               ? 2
+               : (kicker != HAND_KICKER_NONE);
+  *cards = (kicker == HAND_KICKER_PAIR || kicker == HAND_KICKER_DUAL_PAIR)
+               ? 2
+               : (kicker != HAND_KICKER_NONE);
+}
+
+/* shortest chain of a type, 1 for chainless */
+int _Test_ChainMin(int type) {
+  if (!Hand_GetChain(type))
+    return 1;
+
+  switch (Hand_GetPrimal(type)) {
+  case HAND_PRIMAL_SOLO:
+    return HAND_SOLO_CHAIN_MIN_LENGTH;
+  case HAND_PRIMAL_PAIR:
+    return HAND_PAIR_CHAIN_MIN_LENGTH / 2;
+  default:
+    return HAND_TRIO_CHAIN_MIN_LENGTH / 3;
+  }
+}
+
+/* check one enumerated move, return its id */
+int _Test_Move(rank_hand_t* rh) {
+  move_id_t id = Move_FromRankHand(rh);
+  rank_hand_t back;
+
+  Test_Check(id < MOVE_COUNT, "type %d rank %d chain %d kicker %04x has no id",
+             rh->type, rh->rank, rh->chain, rh->kicker);
+
+  if (id >= MOVE_COUNT)
+    return -1;
+
+  Test_Check(!_test_seen[id], "id %d assigned twice", id);
+  _test_seen[id] = 1;
+
+  Test_Check(Move_ToRankHand(id, &back) &&
+                 memcmp(&back, rh, sizeof(rank_hand_t)) == 0,
+             "id %d doesn't convert back", id);
+
+  RankHand_Copy(&_test_moves[id], rh);
+
+  return id;
+}
+
+/* enumerate one class, check its ids are a contiguous block */
+int _Test_Class(int type, int chain) {
+  int lead = 0;
+  int id = 0;
+  int lo = MOVE_COUNT;
+  int hi = -1;
+  int count = 0;
+  int kranks = 0;
+  int kcards = 0;
+  int top = Hand_GetChain(type) ? CARD_RANK_A
+                                : (Hand_GetPrimal(type) == HAND_PRIMAL_SOLO
+                                       ? CARD_RANK_R
+                                       : CARD_RANK_2);
+  uint32_t mask = 0;
+  uint16_t primal = 0;
+  uint16_t allowed = 0;
+  rank_hand_t rh;
+
+  _Test_Kicker(type, &kranks, &kcards);
+
+  for (lead = chain; lead <= top; lead++) {
+    primal = (uint16_t)(((1 << chain) - 1) << (lead - chain + 1));
+    /* ranks 3 ~ R for solo kickers, 3 ~ 2 for pairs, off the primal run */
+    allowed = (uint16_t)((2 << (kcards == 2 ? CARD_RANK_2 : CARD_RANK_R)) - 2);
+    allowed &= (uint16_t)~primal;
+
+    for (mask = 0; mask < 0x10000; mask++) {
+      if ((mask & ~allowed) || LMath_PopCount32(mask) != chain * kranks)
+        continue;
+
+      RankHand_Clear(&rh);
+      rh.type = (uint8_t)type;
+      rh.rank = (uint8_t)lead;
+      rh.chain = (uint8_t)chain;
+      rh.kicker = (uint16_t)mask;
+
+      if ((id = _Test_Move(&rh)) < 0)
+        continue;
+
+      lo = id < lo ? id : lo;
+      hi = id > hi ? id : hi;
+      count++;
+    }
+  }
+
+  Test_Check(count == 0 || hi - lo + 1 == count,
+             "type %d chain %d: %d moves over ids %d ~ %d", type, chain, count,
+             lo, hi);
+
+  return count;
+}
+
+void Test_Universe(void) {
+  int i = 0;
+  int chain = 0;
+  int length = 0;
+  int kranks = 0;
+  int kcards = 0;
+  int total = 0;
+  rank_hand_t rh;
+
+  memset(_test_seen, 0, sizeof(_test_seen));
+
+  for (i = 0; i < TEST_TYPES; i++) {
+    _Test_Kicker(_test_types[i], &kranks, &kcards);
+
+    for (chain = _Test_ChainMin(_test_types[i]);
+         chain <= (Hand_GetChain(_test_types[i]) ? CARD_RANK_A : 1); chain++) {
+      length = chain * (_Test_PrimalCards(_test_types[i]) + kranks * kcards);
+
+      if (length <= HAND_MAX_LENGTH)
+        total += _Test_Class(_test_types[i], chain);
+    }
+  }
+
+  Test_Check(total == MOVE_BOMB_BASE, "%d moves below bombs, expected %d",
+             total, MOVE_BOMB_BASE);
+
+  for (i = CARD_RANK_3; i <= CARD_RANK_2; i++) {
+    RankHand_Clear(&rh);
+    rh.type = HAND_PRIMAL_BOMB;
+    rh.rank = (uint8_t)i;
+    rh.chain = 1;
+    Test_Check(_Test_Move(&rh) == MOVE_BOMB_BASE + i - CARD_RANK_3,
+               "bomb of rank %d out of place", i);
+  }
+
+  RankHand_Clear(&rh);
+  rh.type = HAND_PRIMAL_NUKE;
+  rh.rank = CARD_RANK_R;
+  rh.chain = 1;
+  Test_Check(_Test_Move(&rh) == MOVE_NUKE, "nuke out of place");
+
+  for (i = 0; i < MOVE_COUNT; i++)
+    Test_Check(_test_seen[i], "id %d is no move", i);
+}
+
+/* every reading of array converts to a move id and back */
+void _Test_Readings(card_array_t* array) {
+  int i = 0;
+  int count = 0;
+  move_id_t id = 0;
+  hand_t readings[TEST_READINGS];
+  hand_t hand;
+
+  count = Hand_ParseAll(array, readings, TEST_READINGS);
+
+  for (i = 0; i < count && i < TEST_READINGS; i++) {
+    id = Move_FromHand(&readings[i]);
+    Test_Check(id != MOVE_NONE, "reading of type %d has no id",
+               readings[i].type);
+
+    if (id == MOVE_NONE)
+      continue;
+
+    Test_Check(Move_ToHand(id, &hand, array->cards, array->length) &&
+                   hand.type == readings[i].type &&
+                   Hand_Key(&hand) == Hand_Key(&readings[i]) &&
+                   CardSet_FromCards(hand.cards.cards, hand.cards.length) ==
+                       CardSet_FromCards(readings[i].cards.cards,
+                                         readings[i].cards.length),
+               "reading of type %d doesn't round trip through id %d",
+               readings[i].type, id);
+  }
+}
+
+void Test_RoundTrip(mt19937_t* mt) {
+  int i = 0;
+  int length = 0;
+  card_array_t deck;
+  card_array_t array;
+  hand_t hand;
+
+  /* the cards of every move */
+  CardArray_Reset(&deck);
+
+  for (i = 0; i < MOVE_COUNT; i++) {
+    Test_Check(Move_ToHand((move_id_t)i, &hand, deck.cards, deck.length),
+               "id %d can't be made from a deck", i);
+    CardHand_ToArray(&hand.cards, &array);
+    _Test_Readings(&array);
+  }
+
+  /* random cards, mostly no hand at all */
+  for (i = 0; i < TEST_RANDOM_COUNTS; i++) {
+    CardArray_Reset(&deck);
+    LMath_Shuffle(deck.cards, deck.length, mt);
+    length = 1 + (int)(Random_uint32(mt) % HAND_MAX_LENGTH);
+    CardArray_Clear(&array);
+
+    while (array.length < length)
+      CardArray_PushBack(&array, deck.cards[array.length]);
+
+    _Test_Readings(&array);
+  }
+}
+
+/* beats of a move are what Hand_CompareKey ranks strictly greater */
+void Test_Beats(mt19937_t* mt) {
+  int i = 0;
+  int j = 0;
+  int total = 0;
+  int expect = 0;
+  int length = 0;
+  move_id_t a = 0;
+  move_id_t b = 0;
+  hand_key_t key = 0;
+  card_array_t deck;
+  static rank_hand_t moves[MOVE_COUNT];
+
+  for (i = 0; i < TEST_RANDOM_PAIRS; i++) {
+    a = (move_id_t)(Random_uint32(mt) % MOVE_COUNT);
+    b = (move_id_t)(Random_uint32(mt) % MOVE_COUNT);
+    expect = Hand_CompareKey(RankHand_Key(&_test_moves[a]),
+                             RankHand_Key(&_test_moves[b])) == HAND_CMP_GREATER;
+    Test_Check(Move_Beats(a, b) == expect, "Move_Beats(%d, %d) != %d", a, b,
+               expect);
+  }
+
+  for (i = 0; i < TEST_RANDOM_COUNTS; i++) {
+    CardArray_Reset(&deck);
+    LMath_Shuffle(deck.cards, deck.length, mt);
+    length = 1 + (int)(Random_uint32(mt) % CARD_HAND_PRESET_LENGTH);
+    deck.length = length;
+    RankCount_Build(&deck.ranks, deck.cards, deck.length);
+
+    b = (move_id_t)(Random_uint32(mt) % MOVE_COUNT);
+    key = RankHand_Key(&_test_moves[b]);
+    total = Move_Generate(&deck.ranks, NULL, moves, MOVE_COUNT);
+    expect = 0;
+
+    for (j = 0; j < total && !expect; j++)
+      expect = Hand_CompareKey(RankHand_Key(&moves[j]), key) ==
+               HAND_CMP_GREATER;
+
+    Test_Check(Move_CanBeat(&deck.ranks, &_test_moves[b]) == expect,
+               "Move_CanBeat of id %d with %d cards != %d", b, length, expect);
+  }
+}
+
+/* every byte of count is at least the one of used, counts are below 0x80 */
+int _Test_Fits(const rank_count_t* count, const rank_count_t* used) {
+  const uint64_t high = 0x8080808080808080ULL;
+
+  return (((count->q[0] | high) - used->q[0]) & high) == high &&
+         (((count->q[1] | high) - used->q[1]) & high) == high;
+}
+
+/* compare Move_Generate with the ids brute force finds */
+void _Test_Generate(const rank_count_t* count, move_id_t tobeat) {
+  int i = 0;
+  int n = 0;
+  int total = 0;
+  int capacity = 0;
+  const rank_hand_t* beat = tobeat == MOVE_NONE ? NULL : &_test_moves[tobeat];
+  static rank_count_t used[MOVE_COUNT];
+  static move_id_t expect[MOVE_COUNT];
+  static rank_hand_t moves[MOVE_COUNT];
+  static int ready = 0;
+
+  if (!ready) {
+    for (i = 0; i < MOVE_COUNT; i++)
+      RankHand_Count(&_test_moves[i], &used[i]);
+
+    ready = 1;
+  }
+
+  for (i = 0; i < MOVE_COUNT; i++)
+    if (_Test_Fits(count, &used[i]) &&
+        (tobeat == MOVE_NONE || Move_Beats((move_id_t)i, tobeat)))
+      expect[n++] = (move_id_t)i;
+
+  total = Move_Generate(count, beat, moves, MOVE_COUNT);
+  Test_Check(total == n, "Move_Generate beating %d gives %d plays, not %d",
+             tobeat, total, n);
+
+  for (i = 0; i < total && i < n; i++)
+    Test_Check(Move_FromRankHand(&moves[i]) == expect[i],
+               "play %d beating %d is id %d, not %d", i, tobeat,
+               Move_FromRankHand(&moves[i]), expect[i]);
+
+  /* a short buffer keeps the total and holds the first plays */
+  if (n > 1) {
+    capacity = n / 2;
+    memset(moves, 0, sizeof(rank_hand_t) * n);
+    total = Move_Generate(count, beat, moves, capacity);
+    Test_Check(total == n, "short buffer beating %d gives %d plays, not %d",
+               tobeat, total, n);
+
+    for (i = 0; i < capacity; i++)
+      Test_Check(Move_FromRankHand(&moves[i]) == expect[i],
+                 "short buffer play %d beating %d is not id %d", i, tobeat,
+                 expect[i]);
+
+    Test_Check(moves[capacity].type == HAND_NONE,
+               "short buffer beating %d written past capacity", tobeat);
+  }
+}
+
+/* generated plays of random counts, with and without a hand to beat */
+void Test_Generate(mt19937_t* mt) {
+  int i = 0;
+  card_array_t deck;
+
+  for (i = 0; i < TEST_GENERATE_COUNTS; i++) {
+    CardArray_Reset(&deck);
+    LMath_Shuffle(deck.cards, deck.length, mt);
+    deck.length = 1 + (int)(Random_uint32(mt) % CARD_HAND_PRESET_LENGTH);
+    RankCount_Build(&deck.ranks, deck.cards, deck.length);
+
+    _Test_Generate(&deck.ranks, MOVE_NONE);
+    _Test_Generate(&deck.ranks, (move_id_t)(Random_uint32(mt) % MOVE_COUNT));
+  }
+}
+
+int main(void) {
+  mt19937_t mt;
+
+  Random_Init(&mt, 20141024);
+
+  Test_Universe();
+  Test_RoundTrip(&mt);
+  Test_Beats(&mt);
+  Test_Generate(&mt);
+
+  return Test_Result("move");
+}
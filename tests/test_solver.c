@@ -0,0 +1,107 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * exact solver checks
+ *
+ * on random deals the solver must play out every card in legal hands,
+ * and never use more hands than the advanced analyzer
+ */
+
+#include "test.h"
+
+#define TEST_DEALS 2000
+#define TEST_DEAL_LENGTH 17
+
+/* check the decomposition of one deal */
+void _Test_Deal(solver_t* solver, card_array_t* array) {
+  int i = 0;
+  int cost = 0;
+  hand_list_t hl;
+  hand_list_t advanced;
+  card_array_t played;
+  card_array_t cards;
+  card_array_t copy;
+  hand_t* play = NULL;
+  hand_t hand;
+
+  Solver_Analyze(solver, array, &hl);
+  cost = Solver_Solve(solver, &array->ranks, NULL, NULL);
+  Test_Check(cost == hl.length, "solver cost %d but %d plays", cost,
+             hl.length);
+
+  CardArray_Clear(&played);
+
+  for (i = 0; i < hl.length; i++) {
+    play = HandList_Get(&hl, i);
+    CardHand_ToArray(&play->cards, &cards);
+    CardArray_Concat(&played, &cards);
+
+    Test_Check(Hand_Parse(&hand, &cards) && hand.type == play->type &&
+                   Hand_Key(&hand) == Hand_Key(play),
+               "play %d of deal is not a legal hand", i);
+  }
+
+  Test_Check(CardArray_IsIdentity(&played, array),
+             "plays don't cover the deal, %d of %d cards", played.length,
+             array->length);
+
+  CardArray_Copy(&copy, array);
+  HandList_AdvancedAnalyze(&copy, &advanced);
+  Test_Check(hl.length <= advanced.length,
+             "solver plays %d hands, advanced analyze %d", hl.length,
+             advanced.length);
+}
+
+void Test_Deals(mt19937_t* mt) {
+  int i = 0;
+  solver_t solver;
+  card_array_t deck;
+  card_array_t array;
+
+  Solver_Init(&solver, NULL);
+
+  for (i = 0; i < TEST_DEALS; i++) {
+    CardArray_Reset(&deck);
+    LMath_Shuffle(deck.cards, deck.length, mt);
+    CardArray_Clear(&array);
+
+    while (array.length < TEST_DEAL_LENGTH)
+      CardArray_PushBack(&array, deck.cards[array.length]);
+
+    _Test_Deal(&solver, &array);
+  }
+
+  Solver_Destroy(&solver);
+}
+
+int main(void) {
+  mt19937_t mt;
+
+  Random_Init(&mt, 20141024);
+
+  Test_Deals(&mt);
+
+  return Test_Result("solver");
+}
@@ -0,0 +1,118 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2014 Master.G
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+ * evaluator table generator
+ *
+ * usage: EvalTableGen [standard|advanced] [cards] [path]
+ *
+ * evaluates every rank count with up to cards cards in index order and
+ * writes the table EvalTable_Open maps, cards defaults to
+ * EVAL_TABLE_GEN_CARDS, the file is about EvalTable_Size(cards) bytes
+ */
+
+#include "landlord.h"
+
+#define EVAL_TABLE_GEN_CARDS 14
+#define EVAL_TABLE_GEN_BUFFER 65536
+
+int main(int argc, const char* argv[]) {
+  int cards = EVAL_TABLE_GEN_CARDS;
+  int evaluator = EVAL_CACHE_STANDARD;
+  const char* path = EVAL_TABLE_STANDARD_PATH;
+  uint64_t i = 0;
+  uint64_t n = 0;
+  size_t fill = 0;
+  FILE* fp = NULL;
+  eval_table_header_t header;
+  rank_count_t ranks;
+  card_array_t array;
+  uint8_t buffer[EVAL_TABLE_GEN_BUFFER];
+
+  if (argc > 1 && strcmp(argv[1], "advanced") == 0) {
+    evaluator = EVAL_CACHE_ADVANCED;
+    path = EVAL_TABLE_ADVANCED_PATH;
+  } else if (argc > 1 && strcmp(argv[1], "standard") != 0) {
+    fprintf(stderr, "usage: %s [standard|advanced] [cards] [path]\n",
+            argv[0]);
+    return 1;
+  }
+
+  if (argc > 2)
+    cards = atoi(argv[2]);
+
+  if (argc > 3)
+    path = argv[3];
+
+  if (cards < 0 || cards > EVAL_TABLE_CARDS_MAX) {
+    fprintf(stderr, "cards must be 0 .. %d\n", EVAL_TABLE_CARDS_MAX);
+    return 1;
+  }
+
+  n = EvalTable_Size(cards);
+
+  memset(&header, 0, sizeof(eval_table_header_t));
+  memcpy(header.magic, EVAL_TABLE_MAGIC, sizeof(EVAL_TABLE_MAGIC));
+  header.version = EVAL_TABLE_VERSION;
+  header.evaluator = (uint32_t)evaluator;
+  header.cards = (uint32_t)cards;
+  header.count = n;
+
+  fp = fopen(path, "wb");
+
+  if (fp == NULL) {
+    fprintf(stderr, "can't open %s: %s\n", path, strerror(errno));
+    return 1;
+  }
+
+  fwrite(&header, sizeof(eval_table_header_t), 1, fp);
+
+  for (i = 0; i < n; i++) {
+    EvalTable_Unrank(i, &ranks);
+    /* any suits do, evaluators only read rank counts */
+    CardArray_FromRanks(&array, &ranks);
+
+    buffer[fill++] = (uint8_t)(evaluator == EVAL_CACHE_ADVANCED
+                                   ? HandList_AdvancedEvaluator(&array)
+                                   : HandList_StandardEvaluator(&array));
+
+    if (fill == EVAL_TABLE_GEN_BUFFER || i + 1 == n) {
+      fwrite(buffer, 1, fill, fp);
+      fill = 0;
+      fprintf(stderr, "\r%.1f%%", (double)(i + 1) * 100.0 / (double)n);
+    }
+  }
+
+  fprintf(stderr, "\n");
+
+  if (ferror(fp) | fclose(fp)) {
+    fprintf(stderr, "can't write %s: %s\n", path, strerror(errno));
+    return 1;
+  }
+
+  printf("%s: %llu states with up to %d cards\n", path, (unsigned long long)n,
+         cards);
+
+  return 0;
+}